@@ -1,7 +1,16 @@
-#include "unittest.h"
+#include "unittest_ext.h"
 
 #include "MyClass.h"
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
 using namespace std;
 
 namespace
@@ -46,6 +55,13 @@ namespace
                 IS_EQUAL(tc(6,3), a-b);
              });
 
+   // any callable, not only EXEC: no test steps outside a TEST_CASE, an exception fails it
+   const function<void (void)> s_t05 = []() {
+      if( tc(9,3) != 3 ) throw runtime_error("9/3 != 3");
+   };
+
+   TEST_CASE("/1-Basic/t05", "9/3 => 3, a std::function", s_t05);
+
    TEST_CASE("/2-Advanced/a-01", " (-) 5/5 => 1",
              EXEC {
                IS_EQUAL(tc(55,-5), -11);
@@ -139,5 +155,377 @@ namespace
                 IS_EQUAL(tc(12,3), 4);
              });
 
-}
+   TEST_CASE("/4-Except/e-11", "typed exception check, base classes match",
+             EXEC {
+                EXPECT_THROW_TYPE(std::range_error, tc(5,42));
+                EXPECT_THROW_TYPE(std::runtime_error, tc(5,42));
+                EXPECT_THROW_TYPE(std::exception, tc(5,0));
+                EXPECT_THROW_TYPE(int, tc(5,43));
+             });
+
+   TEST_CASE("/4-Except/e-12", "typed exception check, wrong or no exception",
+             EXEC {
+                EXPECT_THROW_TYPE(std::range_error, tc(5,0));
+                EXPECT_THROW_TYPE(std::range_error, tc(5,45));
+                EXPECT_THROW_TYPE(std::range_error, tc(10,5));
+             });
+
+   // skipped: its prerequisite e-09 fails
+   TEST_CASE("/4-Except/e-14", "runs only after e-09 passed",
+             EXEC {
+                IS_EQUAL(tc(12,3), 4);
+             });
+
+   DEPENDS("/4-Except/e-14", "/4-Except/e-09");
+
+   // fails with SIGSEGV and a backtrace, the run goes on; skipped without --catch-signals
+   TEST_CASE("/4-Except/e-13", "crash: null pointer",
+             EXEC {
+                float * volatile result = nullptr;   // volatile: not known to be null, the write stays
+                *result = tc(10, 5);
+                IS_EQUAL(*result, 2.0f);
+             });
+
+   CRASHES("/4-Except/e-13");
+
+   // skipped: e-13 crashes (--catch-signals) or is skipped
+   TEST_CASE("/4-Except/e-15", "runs only after e-13 passed",
+             EXEC {
+                IS_EQUAL(tc(10,5), 2);
+             });
+
+   DEPENDS("/4-Except/e-15", "/4-Except/e-13");
+
+   TEST_CASE("/5-Repeat/r-01", "fails every 3rd run (see --repeat)",
+             EXEC {
+                static int runs = 0;
+                IS_TRUE(++runs % 3 != 0);
+             });
+
+   TEST_CASE("/6-Range/r-01", "divide 1M values at once",
+             EXEC {
+                vector<float> actual(1000000);
+                vector<float> expected(1000000);
+                for( size_t i = 0; i < actual.size(); ++i )
+                {
+                   actual[i] = tc(i + 5.0f, 4.0f);
+                   expected[i] = (i + 5.0f) * 0.25f;
+                }
+                IS_EQUAL_RANGE(actual, expected);
+                IS_ULP_RANGE(actual, expected, 0);
+             });
 
+   TEST_CASE("/6-Range/r-02", "tolerance; 1/3 is not exact",
+             EXEC {
+                vector<double> actual;
+                vector<double> expected;
+                for( int i = 1; i < 1000; ++i )
+                {
+                   actual.push_back(tc(i, 3));
+                   expected.push_back(i / 3.0);
+                }
+                IS_NEAR_RANGE(actual, expected, 0.0, 1e-6);
+                IS_EQUAL_RANGE(actual, expected);
+             });
+
+   TEST_CASE("/6-Range/r-03", "a/a is a bug",
+             (EXEC {
+                float in[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+                vector<float> actual;
+                for( auto a : in )
+                {
+                   actual.push_back(tc(a, a));
+                }
+                IS_EQUAL_RANGE(actual, vector<float>(8, 1.0f));
+             }));
+
+   struct Division
+   {
+         float a;
+         float b;
+         float expected;
+   };
+
+   const vector<Division> divisions = {
+      { 10, 5, 2 },
+      { 7, 2, 3.5 },
+      { -55, 5, -11 },
+      { 100, .5, 200 },
+      { 3, 3, 1 }
+   };
+
+   TEST_PARAM("/7-Param/table", "a/b from a table", divisions,
+              PEXEC(const Division & d) {
+                 IS_EQUAL(tc(d.a, d.b), d.expected);
+              });
+
+   TEST_PARAM("/7-Param/generated", "(i*7)/7 => i", UT::generate(1000, [](size_t i) { return i + 1.0f; }),
+              PEXEC(float i) {
+                 IS_EQUAL(tc(i * 7, 7), i);
+              });
+
+   TEST_PARAM("/7-Param/cartesian", "(a/b)*b => a", UT::cartesian(vector<float>{ 1, 2, 3 }, vector<float>{ -1, 2, 4 }),
+              PEXEC(const tuple<float, float> & row) {
+                 IS_TRUE(tc(get<0>(row), get<1>(row)) * get<1>(row) == get<0>(row));
+              });
+
+   FUZZ_TEST("/8-Fuzz/divide", "(a/b)*b => a for generated a, b",
+             FEXEC(float a, float b) {
+                if( !(fabs(b) > 1e-6 && fabs(a) < 1e6 && fabs(b) < 1e6) )
+                {
+                   return;
+                }
+                IS_TRUE(fabs(tc(a, b) * b - a) <= 1e-3 * fabs(a) + 1e-3);
+             });
+
+   // built once for the testcases of suite 9-Fixture, shared by them
+   FIXTURE(quotients, "/9-Fixture", vector<float>, {
+      vector<float> * q = new vector<float>(1000000);
+      for( size_t i = 0; i < q->size(); ++i )
+      {
+         (*q)[i] = tc(i * 3.0f, 3.0f);
+      }
+      return q;
+   });
+
+   TEST_CASE("/9-Fixture/f-01", "(10*3)/3 => 10 from the fixture",
+             EXEC {
+                IS_EQUAL(quotients.get()[10], 10);
+             });
+
+   TEST_CASE("/9-Fixture/f-02", "fixture size",
+             EXEC {
+                IS_EQUAL(quotients.get().size(), 1000000u);
+             });
+
+   // the whole suite waits for 1-Basic; f-02 runs after f-01
+   DEPENDS("/9-Fixture", "/1-Basic");
+   DEPENDS("/9-Fixture/f-02", "/9-Fixture/f-01");
+
+   // golden data: data/quotients.bin holds the floats 0 .. 1023, mapped once for both
+   TEST_CASE("/13-Data/d-01", "golden file size and first values",
+             EXEC {
+                const UT::DataFile & golden = UT::testData("quotients.bin", UT::DataFile::Populate);
+                IS_EQUAL(golden.size(), 4096u);
+                IS_EQUAL(golden.view<float>().data()[10], tc(30, 3));
+             });
+
+   TEST_CASE("/13-Data/d-02", "(i*3)/3 => i, all of the golden file (finds the bug at i == 1)",
+             EXEC {
+                vector<float> q(1024);
+                for( size_t i = 0; i < q.size(); ++i )
+                {
+                   q[i] = tc(i * 3.0f, 3.0f);
+                }
+                IS_EQUAL_RANGE(q, UT::testData("quotients.bin").view<float>());
+             });
+
+   TEST_CASE("/13-Data/d-03", "missing data file",
+             EXEC {
+                EXPECT_THROW_TYPE(std::runtime_error, UT::testData("no-such-file.bin"));
+             });
+
+   // output compared with golden files while it is written (--update-snapshots rewrites them)
+   TEST_CASE("/14-Snapshot/s-01", "quotient table against data/snapshots/table.txt",
+             EXEC {
+                UT::Snapshot table("snapshots/table.txt");
+                for( int i = 2; i < 1000; ++i )
+                {
+                   table << i * 7 << " / 7 = " << tc(i * 7, 7) << "\n";
+                }
+                IS_SNAPSHOT(table);
+             });
+
+   TEST_CASE("/14-Snapshot/s-02", "a / a => 1 (the golden file knows better: fails at 2 / 2)",
+             EXEC {
+                string out;
+                for( int a = 1; a < 5; ++a )
+                {
+                   out += to_string(a) + " / " + to_string(a) + " = " + to_string(int(tc(a, a))) + "\n";
+                }
+                IS_EQUAL_SNAPSHOT(out, "snapshots/same.txt");
+             });
+
+   TEST_CASE("/14-Snapshot/s-03", "16 MB of quotients, only their digest is kept",
+             EXEC {
+                UT::Snapshot big("snapshots/big.bin", UT::Snapshot::Digest);
+                vector<float> q(4096);
+                for( int k = 0; k < 1024; ++k )
+                {
+                   for( size_t i = 0; i < q.size(); ++i )
+                   {
+                      q[i] = tc(float(k * 4096 + i), 4096.0f);
+                   }
+                   big.write(reinterpret_cast<const char *>(q.data()), q.size() * sizeof(float));
+                }
+                IS_SNAPSHOT(big);
+             });
+
+   // fails every other run: with --retries 1 it is FLAKY and does not count as failed,
+   // listed in a --quarantine file it does not count either way
+   TEST_CASE("/15-Retry/r-01", "every other run fails",
+             EXEC {
+                static atomic<int> runs(0);
+                IS_EQUAL(++runs % 2, 0);
+             });
+
+   TEST_CASE("/15-Retry/r-02", "always passes, never retried",
+             EXEC {
+                IS_EQUAL(tc(6, 3), 2);
+             });
+
+   // skipped while r-01 failed; once a retry of r-01 passed, it runs as well
+   TEST_CASE("/15-Retry/r-03", "runs after r-01 passed",
+             EXEC {
+                IS_EQUAL(tc(9, 3), 3);
+             });
+
+   DEPENDS("/15-Retry/r-03", "/15-Retry/r-01");
+
+   // retry with exponential backoff, the clock is a template parameter as in production code;
+   // the number of tries, negative if it gave up before the deadline
+   template< typename Clock >
+   int retry(const function<bool (void)> & f, chrono::seconds first, chrono::seconds deadline)
+   {
+      const auto end = Clock::now() + deadline;
+      auto wait = first;
+      int tries = 1;
+      while( !f() )
+      {
+         if( Clock::now() + wait > end )
+         {
+            return -tries;
+         }
+         Clock::sleep_for(wait);
+         wait *= 2;
+         tries++;
+      }
+      return tries;
+   }
+
+   TEST_CASE("/11-Clock/c-01", "gives up after 10 minutes of backoff, at once",
+             EXEC {
+                typedef UT::VirtualClock Clock;
+                IS_EQUAL(retry<Clock>([]() { return false; }, chrono::seconds(1), chrono::seconds(600)), -10);
+                IS_EQUAL(chrono::duration_cast<chrono::seconds>(Clock::now().time_since_epoch()).count(), 511);
+             });
+
+   TEST_CASE("/11-Clock/c-02", "succeeds with the 4th try",
+             EXEC {
+                typedef UT::VirtualClock Clock;
+                int n = 0;
+                IS_EQUAL(retry<Clock>([&n]() { return ++n == 4; }, chrono::seconds(1), chrono::seconds(600)), 4);
+                IS_EQUAL(chrono::duration_cast<chrono::seconds>(Clock::now().time_since_epoch()).count(), 7);
+             });
+
+   TEST_CASE("/11-Clock/c-03", "timers run when the time gets there",
+             EXEC {
+                typedef UT::VirtualClock Clock;
+                IS_EQUAL(Clock::now().time_since_epoch().count(), 0);
+
+                int fired = 0;
+                Clock::after(chrono::minutes(5), [&fired]() { fired++; });
+                Clock::advance(chrono::minutes(4));
+                IS_EQUAL(fired, 0);
+                Clock::advance(chrono::minutes(1));
+                IS_EQUAL(fired, 1);
+                IS_EQUAL(Clock::pending(), 0u);
+             });
+
+   // see --capture: the output shows up with the failed testcase
+   TEST_CASE("/12-Output/o-01", "prints, then fails",
+             EXEC {
+                printf("printf: dividing 10 by 4\n");
+                cout << "cout: expecting 2" << endl;
+                cerr << "cerr: hmm" << endl;
+                IS_EQUAL(tc(10,4), 2);
+             });
+
+   TEST_CASE("/12-Output/o-02", "prints, passes",
+             EXEC {
+                printf("printf: dividing 10 by 5\n");
+                IS_EQUAL(tc(10,5), 2);
+             });
+
+   // a stand-in server on a socketpair: answers "a b" with a/b
+   ASYNC_TEST("/10-Async/a-01", "request and response over a socket", AEXEC {
+      int sv[2];
+      ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv) == 0);
+      const int server = sv[0];
+      const int client = sv[1];
+
+      as.on(server, EPOLLIN, [server](uint32_t) {
+         char buf[64] = {0};
+         float a = 0, b = 0;
+         IS_TRUE(read(server, buf, sizeof(buf) - 1) > 0);
+         IS_EQUAL(sscanf(buf, "%f %f", &a, &b), 2);
+         const string answer = to_string(tc(a, b));
+         IS_TRUE(write(server, answer.data(), answer.size()) > 0);
+      });
+
+      as.on(client, EPOLLIN, [&as, server, client](uint32_t) {
+         char buf[64] = {0};
+         IS_TRUE(read(client, buf, sizeof(buf) - 1) > 0);
+         IS_EQUAL(stof(buf), 2.0f);
+         close(server);
+         close(client);
+         as.done();
+      });
+
+      IS_TRUE(write(client, "10 5", 4) == 4);
+   });
+
+   // a-02 and a-03 wait at the same time: both take 0.1s, together too (a-05 checks)
+   chrono::steady_clock::time_point s_waited[2][2];   // from, to
+
+   ASYNC_TEST("/10-Async/a-02", "waits 0.1s", AEXEC {
+      s_waited[0][0] = chrono::steady_clock::now();
+      as.after(0.1, [&as]() {
+         IS_EQUAL(tc(1, 4), 0.25f);
+         s_waited[0][1] = chrono::steady_clock::now();
+         as.done();
+      });
+   });
+
+   ASYNC_TEST("/10-Async/a-03", "waits 0.1s", AEXEC {
+      s_waited[1][0] = chrono::steady_clock::now();
+      as.after(0.1, [&as]() {
+         IS_EQUAL(tc(3, 4), 0.75f);
+         s_waited[1][1] = chrono::steady_clock::now();
+         as.done();
+      });
+   });
+
+   TEST_CASE("/10-Async/a-05", "a-02 and a-03 waited at the same time",
+             EXEC {
+                IS_TRUE(s_waited[0][1] > s_waited[0][0] && s_waited[1][1] > s_waited[1][0]);
+                const auto from = min(s_waited[0][0], s_waited[1][0]);
+                const auto to = max(s_waited[0][1], s_waited[1][1]);
+                IS_TRUE(to - from < chrono::milliseconds(150));
+             });
+
+   DEPENDS("/10-Async/a-05", "/10-Async/a-02");
+   DEPENDS("/10-Async/a-05", "/10-Async/a-03");
+
+   ASYNC_TEST("/10-Async/a-04", "never done: fails after its timeout", AEXEC {
+      as.timeout(0.05);
+   });
+
+#ifdef UT_COROUTINES
+   CO_TEST("/10-Async/c-01", "the same as a coroutine (C++20)", {
+      int sv[2];
+      ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv) == 0);
+
+      co_await as.sleep(0.01);
+      IS_TRUE(write(sv[1], "10 5", 4) == 4);
+
+      co_await as.readable(sv[0]);
+      char buf[64] = {0};
+      IS_TRUE(read(sv[0], buf, sizeof(buf) - 1) == 4);
+      IS_EQUAL(string(buf), "10 5");
+
+      close(sv[0]);
+      close(sv[1]);
+   });
+#endif
+}
@@ -1,14 +1,46 @@
 // (C) 2013 by Andreas Boerner
-#include "unittest.h"
-
-#include <algorithm>     // find
+#include "unittest_ext.h"
+
+#include <algorithm>     // find, sort
+#include <atomic>
+#include <chrono>        // VirtualClock
+#include <cmath>         // ceil, sqrt
+#include <cerrno>        // errno
+#include <cstring>       // memset, strerror
+#include <condition_variable>
 #include <cxxabi.h>      // abi
 #include <fstream>       // ofstream
 #include <iostream>      // cout, cerr
+#include <limits>        // numeric_limits
 #include <map>
+#include <mutex>
+#include <queue>         // priority_queue
+#include <set>
+#include <thread>
+#include <typeindex>     // type_index
 #include <vector>
+#include <csetjmp>       // sigsetjmp, siglongjmp
+#include <csignal>       // sigaction, sigaltstack
+#include <dirent.h>      // opendir, readdir
+#include <dlfcn.h>       // dladdr
+#include <fcntl.h>       // open
+#include <execinfo.h>    // backtrace
 #include <unistd.h>      // pipe, fork, close, dup2, execlp, read
+#include <poll.h>        // poll
+#include <sched.h>       // sched_setaffinity
+#include <sys/epoll.h>   // epoll_create1, epoll_ctl, epoll_wait
+#include <sys/inotify.h> // inotify_init1, inotify_add_watch
+#include <sys/mman.h>    // memfd_create
 #include <sys/stat.h>    // mkdir
+#include <sys/utsname.h> // uname
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>   // SSE2, AVX
+#include <x86intrin.h>   // __rdtsc
+#endif
+#include <sys/ioctl.h>   // ioctl
+#include <sys/resource.h> // getrusage
+#include <sys/syscall.h> // syscall, __NR_perf_event_open
+#include <linux/perf_event.h>
 using namespace std;
 
 /* There are 3 phases:
@@ -164,1646 +196,7579 @@ namespace {
       return oss.str();
    }
 
-   string typeIdName( const std::exception & e )
+   // demangled once per type
+   struct TypeNames
    {
-      // this c-stuff is NOT exception safe (free()); hope it works anyway...
-      int status;
-      ostringstream oss;
-      char * realname = abi::__cxa_demangle( typeid(e).name(), 0, 0, &status);
-      oss << realname;
-      free(realname);
-      return oss.str();
+         map<type_index, string> m_names {};
+         mutex m_mutex {};
+   };
+
+   TypeNames & typeNames()
+   {
+      static TypeNames t;
+      return t;
    }
 
-   // END: framework stuff ----------------------------------------
+   const string & typeName( const std::type_info & t )
+   {
+      TypeNames & tn = typeNames();
+      lock_guard<mutex> lock(tn.m_mutex);
 
-   void step_failed_isTrue(UT::Probe & probe,
-                           const string & exprStr);
+      auto i = tn.m_names.find(t);
+      if( i == tn.m_names.end() )
+      {
+         // this c-stuff is NOT exception safe (free()); hope it works anyway...
+         int status;
+         char * realname = abi::__cxa_demangle( t.name(), 0, 0, &status);
+         i = tn.m_names.insert(make_pair(type_index(t), string(realname != nullptr ? realname : t.name()))).first;
+         free(realname);
+      }
+      return i->second;
+   }
 
-   template <typename T>
-   struct myLambdaMap {
-         typedef std::map<std::string, T> type;
-   };
+   // an unloaded module takes its type_infos with it
+   void forgetTypeNames()
+   {
+      TypeNames & tn = typeNames();
+      lock_guard<mutex> lock(tn.m_mutex);
+      tn.m_names.clear();
+   }
 
-   struct Teststep
+   string typeIdName( const std::exception & e )
    {
-         bool m_OK = false;
+      return typeName(typeid(e));
+   }
 
-         int m_counter = -1;
-         string m_desc = "";
-         string m_msg = "";
-         string m_EX_expected = "";
-         string m_EX_happened = "";
-         string m_what = "";
+   string printCount( long long c )
+   {
+      ostringstream oss;
 
-         string m_expect = "";
-         string m_actual = "";
+      oss << setprecision(3);
 
-         string dump()
-         {
-            ostringstream oss;
-            oss << "\t\t\t\tTeststep.m_OK          : " << boolalpha << m_OK << "\n"
-                << "\t\t\t\tTeststep.m_counter     : " << m_counter << "\n"
-                << "\t\t\t\tTeststep.m_desc        : " << m_desc << "\n"
-                << "\t\t\t\tTeststep.m_msg         : " << m_msg << "\n"
-                << "\t\t\t\tTeststep.m_expect      : " << m_expect << "\n"
-                << "\t\t\t\tTeststep.m_actual      : " << m_actual << "\n";
+      if( c < 10000 ) {
+         oss << c;
+      } else if( c < 10000000 ) {
+         oss << c / 1000.0 << " k";
+      } else if( c < 10000000000LL ) {
+         oss << c / 1000000.0 << " M";
+      } else {
+         oss << c / 1000000000.0 << " G";
+      }
 
-            oss << "\t\t\t\tTeststep.m_EX_expected    : " << m_EX_expected << "\n";
-            oss << "\t\t\t\tTeststep.m_EX_happened    : " << m_EX_happened << "\n";
+      return oss.str();
+   }
 
-            return oss.str();
-         };
-   };
+   // performance counters (perf_event_open) around m_func()
+   // tries the hardware events first; inside containers or VMs those are
+   // often not available, then the software events are used instead.
+   class PerfCounters
+   {
+      public:
+         static const int MAX = 4;
 
+         PerfCounters() : m_fd(), m_names() {};
+         ~PerfCounters() { close(); };
 
-   struct Testcase
-   {
-         string m_name = "";
-         string m_tpath = "";
-         int m_disabled = false;
-         int m_ts_OK = 0;
-         int m_ts_FAIL = 0;
+         bool open()
+         {
+            static const struct { __u32 type; __u64 config; const char * name; } hw[MAX] = {
+               { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,       "cycles" },
+               { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,     "instructions" },
+               { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,     "cache-misses" },
+               { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,    "branch-misses" } };
+            static const struct { __u32 type; __u64 config; const char * name; } sw[MAX] = {
+               { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK,       "task-clock (ns)" },
+               { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS,      "page-faults" },
+               { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "context-switches" },
+               { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS,   "cpu-migrations" } };
+
+            bool ok = true;
+            for( int i = 0; i < MAX && ok; ++i )
+            {
+               ok = add(hw[i].type, hw[i].config, hw[i].name);
+            }
 
-         string m_expected = "";
-         string m_actual = "";
+            if( !ok )
+            {
+               close();
+               ok = true;
+               for( int i = 0; i < MAX && ok; ++i )
+               {
+                  ok = add(sw[i].type, sw[i].config, sw[i].name);
+               }
+            }
 
-         bool m_is_EX_expected = false;
-         bool m_is_EX_happened = false;
-         string m_EX_expected = "";
-         string m_EX_happened = "";
+            if( !ok )
+            {
+               close();
+            }
 
-         int m_ts_counter = 0;
-         double m_time = 0.0;
+            return ok;
+         }
 
-         map<string, Teststep> m_tstep {};
+         void close()
+         {
+            for( auto fd : m_fd )
+            {
+               ::close(fd);
+            }
+            m_fd.clear();
+            m_names.clear();
+         }
 
-         string dump()
+         void start()
          {
-            ostringstream oss;
-            oss << "\t\tTestcase.m_name     : " << m_name << "\n"
-                << "\t\tTestcase.m_tpath    : " << m_tpath << "\n"
-                << "\t\tTestcase.m_disabled : " <<  m_disabled << "\n"
-                << "\t\tTestcase.m_ts_OK    : " << m_ts_OK << "\n"
-                << "\t\tTestcase.m_ts_FAIL  : " << m_ts_FAIL << "\n"
-                << "\t\tTestcase.m_is_EX_expected : " << boolalpha << m_is_EX_expected << "\n"
-                << "\t\tTestcase.m_is_EX_happened : " << boolalpha << m_is_EX_happened << "\n"
-                << "\t\tTestcase.m_EX_expected: " << m_EX_expected << "\n"
-                << "\t\tTestcase.m_EX_happened: " << m_EX_happened << "\n"
-                << "\t\tTestcase.m_time     : " << m_time << "\n"
-                << "\t\tTestcase.m_ts_counter  : " << m_ts_counter << "\n"
-                << "\t\tTestcase.m_tstep[] =\n";
-            int c = 0;
-            for( auto & i : m_tstep )
+            for( auto fd : m_fd )
             {
-               oss << "\t\t\t[" << c++ << "]: " << i.first << "\n"
-                   << i.second.dump();
+               ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+               ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
             }
+         }
 
-            return oss.str();
-         };
-   };
+         // values are scaled, if the kernel had to multiplex the counters
+         void stop( vector<long long> & values )
+         {
+            for( auto fd : m_fd )
+            {
+               ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
 
-   struct Suite
-   {
-         string m_name = "";
-         int m_tc_OK = 0;
-         int m_tc_FAIL = 0;
-         int m_tc_DISABLED = 0;
+            values.clear();
+            for( auto fd : m_fd )
+            {
+               __u64 buf[3] = { 0, 0, 0 }; // value, time_enabled, time_running
 
-         map<string, Testcase> m_tcs {};
+               if( read(fd, buf, sizeof(buf)) != sizeof(buf) )
+               {
+                  values.push_back(-1);
+               } else if( buf[2] > 0 && buf[2] < buf[1] ) {
+                  values.push_back( static_cast<long long>(buf[0] * (double(buf[1]) / buf[2])) );
+               } else {
+                  values.push_back( static_cast<long long>(buf[0]) );
+               }
+            }
+         }
 
-         string dump()
-         {
-            ostringstream oss;
-            oss << "Suite.m_name       : " << m_name << "\n"
-                << "Suite.m_tc_OK      : " << m_tc_OK << "\n"
-                << "Suite.m_tc_FAIL    : " << m_tc_FAIL << "\n"
-                << "Suite.m_tc_DISABLED: " << m_tc_DISABLED << "\n"
-                << "Suite.m_tcs[] =\n";
+         bool isOpen() const { return !m_fd.empty(); }
+         const vector<string> & names() const { return m_names; }
 
-            int c = 0;
-            for( auto & i : m_tcs )
+      private:
+         bool add( __u32 type, __u64 config, const char * name )
+         {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            // the software events (context switches, migrations) only happen in the kernel
+            attr.exclude_kernel = type == PERF_TYPE_HARDWARE;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // this thread only, any cpu
+            int fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            string n = name;
+            if( fd < 0 && errno == EACCES && !attr.exclude_kernel )
             {
-               oss << "\t[" << c++ << "]: " << i.first << "\n"
-                   << i.second.dump() << "\n";
+               // perf_event_paranoid >= 2: no kernel events for unprivileged users
+               attr.exclude_kernel = 1;
+               fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+               n += " [no kernel]";
+            }
+            if( fd < 0 )
+            {
+               return false;
             }
 
-            return oss.str();
+            m_fd.push_back(fd);
+            m_names.push_back(n);
+            return true;
          }
+
+         vector<int> m_fd;
+         vector<string> m_names;
    };
 
-   class Manager
+   // resource usage of the calling thread (and the process),
+   // a testcase gets the difference of two snapshots
+   struct Usage
    {
-      public:
-         void subscribe( const UT::Probe & sig );
-         void setFilter(const std::string & filter);
-         void setTitle(const std::string & title);
-         void init_phase_1();
-         string dump();
-         void exec();
+         double m_cpu_time = 0.0;       // thread CPU time
+         double m_proc_cpu_time = 0.0;  // process CPU time
+         long m_minflt = 0;             // minor page faults
+         long m_majflt = 0;             // major page faults
+         long m_nvcsw = 0;              // voluntary context switches
+         long m_nivcsw = 0;             // involuntary context switches
+         long m_maxrss = 0;             // max. resident set size (KB), NOT a difference
+         long long m_rchar = 0;         // bytes read (read(), pread(), ...)
+         long long m_wchar = 0;         // bytes written
+         long long m_read_bytes = 0;    // bytes fetched from storage
+         long long m_write_bytes = 0;   // bytes sent to storage
+
+         // begin() reads the CPU clocks last, end() reads them first,
+         // so the /proc access is not accounted to the testcase
+         static Usage begin()
+         {
+            Usage u;
+            u.readIO();
+            u.readRusage();
+            u.readCPU();
+            return u;
+         }
 
-         Testcase & findTC( const UT::Probe & probe );
+         static Usage end()
+         {
+            Usage u;
+            u.readCPU();
+            u.readRusage();
+            u.readIO();
 
-         void setOK( const UT::Probe & sub);
-         void setFAIL(const UT::Probe & sub);
-         void setExpect(const UT::Probe & sub);
-         void printSummary();
-         void genHTML();
-         void genXML();
-         void genPDF();
-         void genStatistics();
+            // reading /proc/.../io counts as reading, too
+            static const long long overhead = ioOverhead();
+            u.m_rchar -= overhead;
 
-         bool m_PDF = true;
-         bool m_debug = false;
-         bool m_ts_all = false;
+            return u;
+         }
 
-      private:
-         void genGtime(const std::string::size_type pos, std::string & line);
-         void genSummary(const std::string::size_type pos, std::string & line);
-         void genSummary2(const std::string::size_type pos, std::string & line);
-         void genSumSuites(const std::string::size_type pos, std::string & line);
-         void genSuites(const std::string::size_type pos, std::string & line);
-         void genTestResults(const std::string::size_type pos, std::string & line);
+         void readCPU()
+         {
+            timespec ts;
 
-         void addTestStep(const UT::Probe & sub, bool okay);
-         void tc_disabled(const UT::Probe & probe);
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            m_cpu_time = ts.tv_sec + ts.tv_nsec / 1000000000.0;
+            clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+            m_proc_cpu_time = ts.tv_sec + ts.tv_nsec / 1000000000.0;
+         }
 
-         string isWarn( int i );
-         string isWarn( bool b );
-         string isError( int i );
-         string isError( bool b );
-         string sumLine( const string & lab, // label
-                         int a,     // total
-                         int b,     // exec'd
-                         int c,     // OK
-                         float d,   // OK %
-                         int e,     // FAIL
-                         float f,   // FAIL %
-                         int g,     // DISABLED
-                         float h    // DISABLED %
-                         );
-      private:
-         myLambdaMap<UT::Probe>::type m_fmap {};
+         void readRusage()
+         {
+            rusage ru;
+            getrusage(RUSAGE_THREAD, &ru);
+            m_minflt = ru.ru_minflt;
+            m_majflt = ru.ru_majflt;
+            m_nvcsw = ru.ru_nvcsw;
+            m_nivcsw = ru.ru_nivcsw;
+            getrusage(RUSAGE_SELF, &ru);
+            m_maxrss = ru.ru_maxrss;
+         }
 
-         std::string m_filter = "";
-         std::string m_title = "";
+         void readIO()
+         {
+            // per thread if the kernel has it (>= 3.17)
+            ifstream io("/proc/thread-self/io");
+            if( !io )
+            {
+               io.open("/proc/self/io");
+            }
 
-         int m_su_OK = 0;
-         int m_su_FAIL = 0;
+            string key;
+            long long value;
+            while( io >> key >> value )
+            {
+               if( key == "rchar:" )            m_rchar = value;
+               else if( key == "wchar:" )       m_wchar = value;
+               else if( key == "read_bytes:" )  m_read_bytes = value;
+               else if( key == "write_bytes:" ) m_write_bytes = value;
+            }
+         }
 
-         map<string, Suite> m_suites {};
-   };
+         static long long ioOverhead()
+         {
+            Usage a, b;
+            a.readIO();
+            b.readIO();
+            return b.m_rchar - a.m_rchar;
+         }
 
-   typedef Singleton<Manager> S_Manager;
+         Usage operator-(const Usage & start) const
+         {
+            Usage u;
+            u.m_cpu_time = m_cpu_time - start.m_cpu_time;
+            u.m_proc_cpu_time = m_proc_cpu_time - start.m_proc_cpu_time;
+            u.m_minflt = m_minflt - start.m_minflt;
+            u.m_majflt = m_majflt - start.m_majflt;
+            u.m_nvcsw = m_nvcsw - start.m_nvcsw;
+            u.m_nivcsw = m_nivcsw - start.m_nivcsw;
+            u.m_maxrss = m_maxrss;
+            u.m_rchar = m_rchar - start.m_rchar;
+            u.m_wchar = m_wchar - start.m_wchar;
+            u.m_read_bytes = m_read_bytes - start.m_read_bytes;
+            u.m_write_bytes = m_write_bytes - start.m_write_bytes;
+            return u;
+         }
 
-   string Manager::dump()
-   {
-      ostringstream oss;
-      oss << "m_filter : " << m_filter << "\n"
-          << "m_title  : " << m_title << "\n"
-          << "m_su_OK  : " << m_su_OK << "\n"
-          << "m_su_FAIL: " << m_su_FAIL << "\n";
+         string dump()
+         {
+            ostringstream oss;
+            oss << "\t\tUsage.m_cpu_time     : " << m_cpu_time << "\n"
+                << "\t\tUsage.m_proc_cpu_time: " << m_proc_cpu_time << "\n"
+                << "\t\tUsage.m_minflt       : " << m_minflt << "\n"
+                << "\t\tUsage.m_majflt       : " << m_majflt << "\n"
+                << "\t\tUsage.m_nvcsw        : " << m_nvcsw << "\n"
+                << "\t\tUsage.m_nivcsw       : " << m_nivcsw << "\n"
+                << "\t\tUsage.m_maxrss       : " << m_maxrss << "\n"
+                << "\t\tUsage.m_rchar        : " << m_rchar << "\n"
+                << "\t\tUsage.m_wchar        : " << m_wchar << "\n"
+                << "\t\tUsage.m_read_bytes   : " << m_read_bytes << "\n"
+                << "\t\tUsage.m_write_bytes  : " << m_write_bytes << "\n";
+            return oss.str();
+         }
+   };
 
-      oss << " === m_fmap ======================\n";
+   // distribution of the times of repeated runs
+   struct Stats
+   {
+         double m_median = 0.0;
+         double m_p95 = 0.0;
+         double m_mean = 0.0;
+         double m_stddev = 0.0;
+         double m_min = 0.0;
+         double m_max = 0.0;
+
+         static Stats of( vector<double> v )
+         {
+            Stats st;
+            if( v.empty() )
+            {
+               return st;
+            }
 
-      int c = 0;
-      for( auto & i : m_fmap )
-      {
-         oss << "[" << c++ << "] <" << i.first << "> -> Probe\n"
-             << i.second.dump() << "\n\n";
-      }
+            sort(v.begin(), v.end());
 
-      oss << " === m_suites ====================\n";
+            auto n = v.size();
+            st.m_min = v.front();
+            st.m_max = v.back();
+            st.m_median = n % 2 ? v[n/2] : (v[n/2 - 1] + v[n/2]) / 2.0;
+            st.m_p95 = v[ min(n - 1, static_cast<size_t>(ceil(0.95 * n)) - 1) ];
 
-      int s = 0;
-      for( auto & i : m_suites )
-      {
-         oss << "[" << s++ << "] " << i.first << "\n";
-         oss << i.second.dump() << "\n\n";
-      }
+            double sum = 0.0;
+            for( auto t : v )
+            {
+               sum += t;
+            }
+            st.m_mean = sum / n;
 
-      return oss.str();
-   }
+            double sq = 0.0;
+            for( auto t : v )
+            {
+               sq += (t - st.m_mean) * (t - st.m_mean);
+            }
+            st.m_stddev = n > 1 ? sqrt(sq / (n - 1)) : 0.0;
 
-   // ===============================================================================
-   // Probe code
+            return st;
+         }
+   };
 
-   void checkForDisable(const string & hierName, bool & disabled, string & newName)
+   // "0-3,6" => 0 1 2 3 6 (the format of --cpus and /sys/devices/system/cpu/*)
+   vector<int> parseCpuList( const string & list )
    {
-      const string Disable = "/DISABLE";
+      vector<int> cpus;
+      istringstream in(list);
+      string range;
 
-      auto pos = hierName.find(Disable);
-
-      if( pos == string::npos )
+      while( getline(in, range, ',') )
       {
-         disabled = false;
-         newName = hierName;
-         return;
-      }
-
-      if( pos == hierName.size() - Disable.size() )
-      {
-         disabled = true;
-         newName = hierName.substr(0, pos);
-      } else {
-         cerr << "WARNING: " << Disable << " NOT at end of <" << hierName
-              << ">, so NOT disabled!" << endl;
-         disabled = false;
-         newName = hierName;
-      }
-   }
-
-   void convertNames(const string & hierName,
-                     string & suite,
-                     string & name,
-                     bool & disabled)
-   {
-      string newName;
-      checkForDisable(hierName, disabled, newName);
-
-      auto pos = newName.find("/");
-      if( pos == string::npos )
-      {
-         suite = "default";
-         name = newName;
-         return;
-      }
-
-      if( pos == 0 )
-      {
-         pos = newName.find("/",1);
-
-         // if there's no '/' in the name, then assume suite is 'default'
-         if( pos == string::npos)
+         if( range.find_first_not_of(" \n") == string::npos )
          {
-            suite = "default";
-            name = newName.substr(1);
-            return;
-         } else {
-            suite = newName.substr(1,pos-1);
-            name = newName.substr(pos+1);
-            return;
+            continue;
+         }
+         const auto dash = range.find('-');
+         const int from = stoi(range.substr(0, dash));
+         const int to = dash == string::npos ? from : stoi(range.substr(dash + 1));
+         if( from < 0 || to < from || to >= CPU_SETSIZE )
+         {
+            throw runtime_error("invalid cpu list <" + list + ">");
+         }
+         for( int c = from; c <= to; ++c )
+         {
+            cpus.push_back(c);
          }
-      } else {
-         suite = newName.substr(0,pos);
-         name = newName.substr(pos+1);
-         return;
       }
+      return cpus;
    }
 
-// ===============================================================================
-// Manager code
-
-   void Manager::subscribe( const UT::Probe & probe )
+   string printCpuList( const vector<int> & cpus )
    {
-      m_fmap.insert(make_pair(probe.m_tpath, probe));
-
-      auto p = m_suites.find(probe.m_suite);
-      if( p == m_suites.end() )
-      {
-         Suite suite;
-         suite.m_name = probe.m_suite;
-         // suite.m_tc_DISABLED = probe.m_disabled; // not yet
-         p = m_suites.insert( make_pair(probe.m_suite, suite) ).first;
-      }
-
-      Testcase tc;
-      tc.m_name = probe.m_tname;
-      tc.m_disabled = probe.m_disabled;
-      tc.m_tpath = probe.m_tpath;
-
-      auto t = p->second.m_tcs.find( probe.m_tname );
-      if( t != p->second.m_tcs.end() )
+      ostringstream oss;
+      for( size_t i = 0; i < cpus.size(); )
       {
-         cerr << "ERROR: two testcases have the same name!\n"
-              << "1st: " << p->second.m_name << "/" << t->second.m_name<< " in ";
-         auto ftc = m_fmap.find( tc.m_tpath );
-         if( ftc == m_fmap.end() )
+         size_t j = i;
+         while( j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1 )
          {
-            throw logic_error("think I have already a duplicate tc, but can't find it!");
+            ++j;
          }
-
-         cerr << ftc->second.m_fname << ":" << ftc->second.m_line << "\n"
-              << "2nd: " << probe.m_tpath << " in " << probe.m_fname << ":"
-              << probe.m_line << endl;
-         throw runtime_error("duplicate Testcase names !");
+         oss << (i > 0 ? "," : "") << cpus[i];
+         if( j > i )
+         {
+            oss << "-" << cpus[j];
+         }
+         i = j + 1;
       }
+      return oss.str();
+   }
 
-      p->second.m_tcs.insert( make_pair( tc.m_name, tc ) );
+   // first line of a /proc or /sys file, "" if there's none
+   string readLine( const string & path )
+   {
+      ifstream in(path);
+      string line;
+      getline(in, line);
+      return line;
    }
 
-   void Manager::setTitle(const string & title)
+   // the calling thread runs on this cpu only
+   void pinThread( int cpu )
    {
-      if( m_title.size() > 0 )
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      if( sched_setaffinity(0, sizeof(set), &set) != 0 )
       {
-         cerr << "Title was already set to <" << m_title << ">\n"
-              << " ignoring <" << title << ">" << endl;
-         return;
+         throw runtime_error("can't pin thread to cpu " + to_string(cpu) + ": " + strerror(errno));
       }
-
-      m_title = title;
    }
 
-   void Manager::setFilter(const string & filter)
+   // where the tests run: the header of the reports, so timings can be audited
+   struct Host
    {
-      m_filter = filter;
-   }
+         string m_name = "";
+         string m_kernel = "";
+         string m_model = "";        // cpu model name
+         string m_online = "";       // online cpus
+         string m_isolated = "";     // isolcpus=
+         int m_nodes = 1;            // NUMA nodes
+         int m_smt = 1;              // hardware threads per core
+         string m_affinity = "";     // cpus the process may run on
+         string m_governor = "";     // cpufreq governor(s) of these cpus
+         string m_loadavg = "";      // 1, 5, 15 minutes
+         int m_nice = 0;
+
+         static Host probe()
+         {
+            Host h;
 
+            char buf[256] = "";
+            gethostname(buf, sizeof(buf) - 1);
+            h.m_name = buf;
 
-   // ===  Manager end  =======================
+            utsname u;
+            if( uname(&u) == 0 )
+            {
+               h.m_kernel = string(u.sysname) + " " + u.release + " " + u.machine;
+            }
 
-   void step_failed_isTrue(UT::Probe & probe,
-                           const string & exprStr)
-   {
-      probe.m_msg = "assert violation";
+            ifstream info("/proc/cpuinfo");
+            string line;
+            while( getline(info, line) )
+            {
+               if( line.compare(0, 10, "model name") == 0 )
+               {
+                  h.m_model = line.substr(line.find(':') + 2);
+                  break;
+               }
+            }
 
-      ostringstream oss;
-      oss << "[ " << exprStr << " ]";
-      probe.m_expect = oss.str() ;
+            h.m_online = readLine("/sys/devices/system/cpu/online");
+            h.m_isolated = readLine("/sys/devices/system/cpu/isolated");
 
-      probe.m_expect += " => true";
-      probe.m_actual = "   => false";
+            const string nodes = readLine("/sys/devices/system/node/online");
+            if( nodes.size() > 0 )
+            {
+               h.m_nodes = parseCpuList(nodes).size();
+            }
 
-      S_Manager::getInstance().setFAIL(probe);
-   }
+            const string siblings = readLine("/sys/devices/system/cpu/cpu0/topology/thread_siblings_list");
+            if( siblings.size() > 0 )
+            {
+               h.m_smt = parseCpuList(siblings).size();
+            }
 
-   void Manager::setOK(const UT::Probe & probe)
-   {
-      addTestStep(probe, true );
-   }
+            vector<int> cpus;
+            cpu_set_t mask;
+            if( sched_getaffinity(0, sizeof(mask), &mask) == 0 )
+            {
+               for( int c = 0; c < CPU_SETSIZE; ++c )
+               {
+                  if( CPU_ISSET(c, &mask) )
+                  {
+                     cpus.push_back(c);
+                  }
+               }
+            }
+            h.m_affinity = printCpuList(cpus);
 
-   void Manager::setFAIL(const UT::Probe & probe)
-   {
-      addTestStep(probe, false );
-   }
+            set<string> governors;
+            for( auto c : cpus )
+            {
+               const string g = readLine("/sys/devices/system/cpu/cpu" + to_string(c) + "/cpufreq/scaling_governor");
+               governors.insert(g.size() > 0 ? g : "n/a");
+            }
+            for( auto & g : governors )
+            {
+               h.m_governor += (h.m_governor.empty() ? "" : ",") + g;
+            }
 
-   Testcase & Manager::findTC( const UT::Probe & probe )
-   {
-      auto p = m_suites.find(probe.m_suite);
-      if( p == m_suites.end() )
-      {
-         throw runtime_error("Suite not found!");
-      }
+            h.m_loadavg = readLine("/proc/loadavg");
+            h.m_loadavg = h.m_loadavg.substr(0, h.m_loadavg.find(' ', h.m_loadavg.find(' ', h.m_loadavg.find(' ') + 1) + 1));
 
-      auto q = p->second.m_tcs.find(probe.m_tname);
-      if( q == p->second.m_tcs.end() )
-      {
-         throw runtime_error("Testcase not found!");
-      }
+            errno = 0;
+            h.m_nice = getpriority(PRIO_PROCESS, 0);
 
-      return q->second;
-   }
+            return h;
+         }
 
-   void Manager::addTestStep( const UT::Probe & probe, bool okay)
-   {
-      Teststep ts;
-      ts.m_OK = okay;
-      ts.m_desc = probe.m_desc;
-      ts.m_expect = probe.m_expect;
-      ts.m_actual = probe.m_actual;
-      ts.m_EX_expected = probe.m_EX_expected;
-      ts.m_EX_happened = probe.m_EX_happened;
-      ts.m_what = probe.m_what;
-      ts.m_msg = probe.m_msg;
+         // one line for the console and the html header
+         string text() const
+         {
+            ostringstream oss;
+            oss << m_name << ", " << m_kernel << ", " << m_model
+                << ", cpus " << m_online << " (" << m_nodes << " NUMA node" << (m_nodes > 1 ? "s" : "")
+                << ", " << m_smt << " thread" << (m_smt > 1 ? "s" : "") << "/core";
+            if( m_isolated.size() > 0 )
+            {
+               oss << ", isolated " << m_isolated;
+            }
+            oss << "), running on " << m_affinity << ", governor " << m_governor
+                << ", nice " << m_nice << ", load " << m_loadavg;
+            return oss.str();
+         }
+   };
 
-      if( probe.m_EX_expected != probe.m_EX_happened )
+   // size of the last level cache of cpu0 in bytes, 0 if unknown
+   size_t llcSize()
+   {
+      int level = 0;
+      size_t size = 0;
+      for( int i = 0; i < 16; ++i )
       {
-         ts.m_OK = false;
-         if( probe.m_EX_expected.size() == 0 )
+         const string dir = "/sys/devices/system/cpu/cpu0/cache/index" + to_string(i) + "/";
+         const string l = readLine(dir + "level");
+         if( l.empty() )
          {
-            ts.m_msg = "unexpected exception occured!";
-         } else {
-            ts.m_msg = "exceptions do NOT match";
+            break;
          }
-
-         if( probe.m_EX_happened == "(UNKNOWN)" )
+         if( readLine(dir + "type") == "Instruction" || stoi(l) < level )
          {
-            ts.m_msg += " (UNKNOWN) means it was not derived from std::exception.";
+            continue;
          }
-      }
-
-      auto & p = findTC( probe );
 
-      ts.m_counter = ++p.m_ts_counter;
-
-      ostringstream oss;
-      oss << "TS-" << setfill('0') << setw(3) << ts.m_counter;
-      string tsName = oss.str();
-
-      p.m_tstep.insert(make_pair( tsName, ts));
+         // "32768K"
+         const string s = readLine(dir + "size");
+         size_t n = s.empty() ? 0 : stoul(s);
+         n *= s.find('K') != string::npos ? 1024 : s.find('M') != string::npos ? 1024 * 1024 : 1;
+         level = stoi(l);
+         size = n;
+      }
 
-      if( ts.m_OK )
+      if( size == 0 )
       {
-         cout << "passed: ";
-      } else {
-         cout << "FAILED: ";
+         const long n = sysconf(_SC_LEVEL3_CACHE_SIZE);
+         size = n > 0 ? n : 0;
       }
-
-      cout << "<" << p.m_name << "> - " << tsName << endl;
+      return size;
    }
 
-   void Manager::setExpect(const UT::Probe & probe)
+   // --cold: before a measured run the caches are evicted by writing to a buffer twice
+   // the size of the last level cache (dirty lines of the testcase are written back).
+   // Its 4 KB pages outnumber the TLB entries, so the TLB is cold as well.
+   // --drop-caches: the page cache, too (root only)
+   struct CacheEvictor
    {
-      auto & p = findTC( probe );
-
-      p.m_is_EX_expected = true;
-      p.m_EX_expected = probe.m_EX_expected;
-   }
+         unsigned char * m_buf = nullptr;
+         size_t m_size = 0;
+         size_t m_llc = 0;
+         bool m_drop_pages = false;
+         unsigned char m_round = 0;
+         mutex m_mutex {};   // -j: the workers evict one at a time
+
+         CacheEvictor() = default;
+         CacheEvictor( const CacheEvictor & ) = delete;
+         CacheEvictor & operator=( const CacheEvictor & ) = delete;
+
+         ~CacheEvictor()
+         {
+            if( m_buf != nullptr )
+            {
+               munmap(m_buf, m_size);
+            }
+         }
 
+         void init()
+         {
+            if( m_buf != nullptr )
+            {
+               return;
+            }
 
-   void Manager::genStatistics()
-   {
-      int su_OK = 0;
-      int su_FAIL = 0;
+            m_llc = llcSize();
+            m_size = max<size_t>(2 * m_llc, 64 * 1024 * 1024);
 
-      for( auto & su : m_suites )
-      {
-         int tc_OK = 0;
-         int tc_FAIL = 0;
-         int tc_DISABLED = 0;
+            void * p = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if( p == MAP_FAILED )
+            {
+               throw runtime_error(string("--cold: mmap: ") + strerror(errno));
+            }
+            madvise(p, m_size, MADV_NOHUGEPAGE);
+            m_buf = static_cast<unsigned char *>(p);
+            memset(m_buf, 0, m_size);
+         }
 
-         for( auto & tc : su.second.m_tcs )
+         void evict()
          {
-            int ts_OK = 0;
-            int ts_FAIL = 0;
-            for( auto & ts : tc.second.m_tstep )
+            lock_guard<mutex> lock(m_mutex);
+
+            if( m_drop_pages )
             {
-               if( ts.second.m_OK )
+               sync();
+               ofstream drop("/proc/sys/vm/drop_caches");
+               if( !(drop << "1" << flush) )
                {
-                  ts_OK++;
-               } else {
-                  ts_FAIL++;
+                  cerr << "WARNING: can't write /proc/sys/vm/drop_caches (not root?), "
+                       << "page cache is not dropped." << endl;
+                  m_drop_pages = false;
                }
             }
 
-            tc.second.m_ts_OK = ts_OK;
-            tc.second.m_ts_FAIL = ts_FAIL;
-
-            if( tc.second.m_ts_OK > 0 && tc.second.m_disabled )
+            // a new value each time, the stores can't be skipped
+            const unsigned char v = ++m_round;
+            volatile unsigned char * b = m_buf;
+            for( size_t i = 0; i < m_size; i += 64 )
             {
-               throw logic_error("Testcase skipped, but teststeps exec'd OK ?!");
+               b[i] = v;
             }
+         }
+   };
 
-            if( tc.second.m_disabled )
-            {
-               tc_DISABLED++;
-            } else if (tc.second.m_ts_FAIL == 0)
+   CacheEvictor s_evictor;
+
+   // XXH64 (seed 0), fed in pieces of any size; the digest of the snapshots
+   struct Hash64
+   {
+         static const uint64_t P1 = 11400714785074694791ULL;
+         static const uint64_t P2 = 14029467366897019727ULL;
+         static const uint64_t P3 = 1609587929392839161ULL;
+         static const uint64_t P4 = 9650029242287828579ULL;
+         static const uint64_t P5 = 2870177450012600261ULL;
+
+         uint64_t m_v[4] = { P1 + P2, P2, 0, 0 - P1 };
+         unsigned char m_buf[32] = {};
+         size_t m_fill = 0;
+         uint64_t m_total = 0;
+
+         static uint64_t rotl( uint64_t x, int r ) { return (x << r) | (x >> (64 - r)); }
+         static uint64_t round( uint64_t acc, uint64_t in ) { return rotl(acc + in * P2, 31) * P1; }
+         static uint64_t read64( const unsigned char * p ) { uint64_t v; memcpy(&v, p, 8); return v; }
+         static uint32_t read32( const unsigned char * p ) { uint32_t v; memcpy(&v, p, 4); return v; }
+
+         void stripe( const unsigned char * p )
+         {
+            for( int i = 0; i < 4; ++i )
             {
-               tc_OK++;
-            } else {
-               tc_FAIL++;
+               m_v[i] = round(m_v[i], read64(p + 8 * i));
             }
          }
 
-         su.second.m_tc_OK = tc_OK;
-         su.second.m_tc_FAIL = tc_FAIL;
-         su.second.m_tc_DISABLED = tc_DISABLED;
+         void update( const void * data, size_t n )
+         {
+            const unsigned char * p = static_cast<const unsigned char *>(data);
+            m_total += n;
 
-         if( tc_FAIL > 0 )
+            if( m_fill > 0 )
+            {
+               const size_t k = min(n, 32 - m_fill);
+               memcpy(m_buf + m_fill, p, k);
+               m_fill += k;
+               p += k;
+               n -= k;
+               if( m_fill < 32 )
+               {
+                  return;
+               }
+               stripe(m_buf);
+               m_fill = 0;
+            }
+
+            for( ; n >= 32; p += 32, n -= 32 )
+            {
+               stripe(p);
+            }
+
+            memcpy(m_buf, p, n);
+            m_fill = n;
+         }
+
+         uint64_t digest() const
          {
-            su_FAIL++;
-         } else {
-            su_OK++;
+            uint64_t h;
+            if( m_total >= 32 )
+            {
+               h = rotl(m_v[0], 1) + rotl(m_v[1], 7) + rotl(m_v[2], 12) + rotl(m_v[3], 18);
+               for( auto v : m_v )
+               {
+                  h = (h ^ round(0, v)) * P1 + P4;
+               }
+            } else {
+               h = P5;
+            }
+            h += m_total;
+
+            const unsigned char * p = m_buf;
+            size_t n = m_fill;
+            for( ; n >= 8; p += 8, n -= 8 )
+            {
+               h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+            }
+            if( n >= 4 )
+            {
+               h = rotl(h ^ (read32(p) * P1), 23) * P2 + P3;
+               p += 4;
+               n -= 4;
+            }
+            for( ; n > 0; ++p, --n )
+            {
+               h = rotl(h ^ (*p * P5), 11) * P1;
+            }
+
+            h ^= h >> 33;
+            h *= P2;
+            h ^= h >> 29;
+            h *= P3;
+            h ^= h >> 32;
+            return h;
          }
+   };
+
+   string printBytes( long long b )
+   {
+      ostringstream oss;
+
+      oss << setprecision(3);
+
+      if( b < 1024 ) {
+         oss << b << " B";
+      } else if( b < 1024 * 1024 ) {
+         oss << b / 1024.0 << " KB";
+      } else if( b < 1024LL * 1024 * 1024 ) {
+         oss << b / (1024.0 * 1024) << " MB";
+      } else {
+         oss << b / (1024.0 * 1024 * 1024) << " GB";
       }
 
-      m_su_OK = su_OK;
-      m_su_FAIL = su_FAIL;
+      return oss.str();
    }
 
-
-   void Manager::printSummary()
+   string xmlEscape( const string & str )
    {
-      cout << "\nSUMMARY: ==========================\n";
-      cout << "  test suites:\n";
+      string rc;
+      rc.reserve(str.size());
 
-      if( m_suites.size() < 1 )
+      for( auto c : str )
       {
-         cout << "BAD: NO suites registered..." << endl;
-         return;
+         switch( c )
+         {
+            case '<':  rc += "&lt;"; break;
+            case '>':  rc += "&gt;"; break;
+            case '&':  rc += "&amp;"; break;
+            case '"':  rc += "&quot;"; break;
+            case '\'': rc += "&apos;"; break;
+            default:   rc += c;
+         }
       }
 
-      cout << "    exec'd  : \t" << m_suites.size() << endl;
-      cout << "     OK     : \t" << m_su_OK << "\t" << m_su_OK * 100 / m_suites.size() << "%" << endl;
-      cout << "     FAILED : \t" << m_su_FAIL << "\t" << m_su_FAIL * 100 / m_suites.size() << "%" << endl;
-      cout << "\n  test cases:\n";
+      return rc;
+   }
 
-      int tc_OK = 0;
-      int tc_FAIL = 0;
-      int tc_DISABLE = 0;
+   string jsonEscape( const string & str )
+   {
+      string rc;
+      rc.reserve(str.size());
 
-      for( auto & i : m_suites )
+      for( auto c : str )
       {
-         tc_OK += i.second.m_tc_OK;
-         tc_FAIL += i.second.m_tc_FAIL;
-         tc_DISABLE += i.second.m_tc_DISABLED;
+         switch( c )
+         {
+            case '"':  rc += "\\\""; break;
+            case '\\': rc += "\\\\"; break;
+            case '\n': rc += "\\n"; break;
+            case '\t': rc += "\\t"; break;
+            default:
+               if( static_cast<unsigned char>(c) < 0x20 )
+               {
+                  char buf[8];
+                  snprintf(buf, sizeof(buf), "\\u%04x", c);
+                  rc += buf;
+               } else {
+                  rc += c;
+               }
+         }
       }
 
-      int tc_exec = tc_OK + tc_FAIL;
+      return rc;
+   }
 
-      if( tc_exec < 1 )
+   // kernels of the range assertions ------------------------------
+
+   // elements per block; only blocks with mismatches are scanned again for the indices
+   const size_t RangeBlock = 4096;
+
+   template <typename T>
+   inline bool isNear( T a, T b, T absTol, T relTol )
+   {
+      const T d = fabs(a - b);
+      return a == b || d <= absTol || d <= relTol * max(fabs(a), fabs(b));
+   }
+
+   template <typename T, typename U>
+   inline U ulpKey( T v )
+   {
+      // maps the float bits to unsigned ints with the same order
+      const U sign = U(1) << (sizeof(U) * 8 - 1);
+      U u;
+      memcpy(&u, &v, sizeof(u));
+      return (u & sign) ? ~u : (u | sign);
+   }
+
+   template <typename T, typename U>
+   inline bool isUlp( T a, T b, unsigned long long ulps )
+   {
+      if( a == b )
       {
-         cout << "BAD: ALL testcases were DISABLED..." << endl;
-         return;
+         return true;
+      }
+      if( a != a || b != b )
+      {
+         return false;
       }
+      const U ka = ulpKey<T, U>(a);
+      const U kb = ulpKey<T, U>(b);
+      return (ka > kb ? ka - kb : kb - ka) <= ulps;
+   }
 
-      if( m_fmap.size() < 1 )
+   template <typename T, typename U>
+   size_t countUlp( const T * a, const T * b, size_t n, unsigned long long ulps )
+   {
+      size_t c = 0;
+      for( size_t i = 0; i < n; ++i )
       {
-         cout << "BAD: NO testcases were registed..." << endl;
-         return;
+         c += !isUlp<T, U>(a[i], b[i], ulps);
       }
+      return c;
+   }
 
-      cout << "    exec'd  : \t" << tc_exec << "\t" << tc_exec * 100 / (tc_exec + tc_DISABLE) << "%" << endl;
-      cout << "    disabled: \t" << tc_DISABLE << "\t" << tc_DISABLE * 100 / m_fmap.size() << "%" << endl;
-      cout << "     OK     : \t" << tc_OK << "\t" << tc_OK * 100 / tc_exec << "%" << endl;
-      cout << "     FAILED : \t" << tc_FAIL << "\t" << tc_FAIL * 100 / tc_exec << "%" << endl;
-      cout << "\n  test steps:\n";
+#if defined(__x86_64__) || defined(__i386__)
+   __attribute__((target("avx")))
+   size_t countNearAVX( const float * a, const float * b, size_t n, float absTol, float relTol, size_t & i )
+   {
+      size_t c = 0;
+      const __m256 sign = _mm256_set1_ps(-0.0f);
+      const __m256 at = _mm256_set1_ps(absTol);
+      const __m256 rt = _mm256_set1_ps(relTol);
+      for( ; i + 8 <= n; i += 8 )
+      {
+         const __m256 x = _mm256_loadu_ps(a + i);
+         const __m256 y = _mm256_loadu_ps(b + i);
+         const __m256 d = _mm256_andnot_ps(sign, _mm256_sub_ps(x, y));
+         const __m256 m = _mm256_max_ps(_mm256_andnot_ps(sign, x), _mm256_andnot_ps(sign, y));
+         const __m256 ok = _mm256_or_ps(_mm256_cmp_ps(x, y, _CMP_EQ_OQ),
+                                        _mm256_or_ps(_mm256_cmp_ps(d, at, _CMP_LE_OQ),
+                                                     _mm256_cmp_ps(d, _mm256_mul_ps(rt, m), _CMP_LE_OQ)));
+         c += 8 - __builtin_popcount(_mm256_movemask_ps(ok));
+      }
+      return c;
+   }
 
-      int ts_OK = 0;
-      int ts_FAIL = 0;
+   __attribute__((target("avx")))
+   size_t countNearAVX( const double * a, const double * b, size_t n, double absTol, double relTol, size_t & i )
+   {
+      size_t c = 0;
+      const __m256d sign = _mm256_set1_pd(-0.0);
+      const __m256d at = _mm256_set1_pd(absTol);
+      const __m256d rt = _mm256_set1_pd(relTol);
+      for( ; i + 4 <= n; i += 4 )
+      {
+         const __m256d x = _mm256_loadu_pd(a + i);
+         const __m256d y = _mm256_loadu_pd(b + i);
+         const __m256d d = _mm256_andnot_pd(sign, _mm256_sub_pd(x, y));
+         const __m256d m = _mm256_max_pd(_mm256_andnot_pd(sign, x), _mm256_andnot_pd(sign, y));
+         const __m256d ok = _mm256_or_pd(_mm256_cmp_pd(x, y, _CMP_EQ_OQ),
+                                         _mm256_or_pd(_mm256_cmp_pd(d, at, _CMP_LE_OQ),
+                                                      _mm256_cmp_pd(d, _mm256_mul_pd(rt, m), _CMP_LE_OQ)));
+         c += 4 - __builtin_popcount(_mm256_movemask_pd(ok));
+      }
+      return c;
+   }
 
-      for( auto & i : m_suites )
+   size_t countNearSSE( const float * a, const float * b, size_t n, float absTol, float relTol, size_t & i )
+   {
+      size_t c = 0;
+      const __m128 sign = _mm_set1_ps(-0.0f);
+      const __m128 at = _mm_set1_ps(absTol);
+      const __m128 rt = _mm_set1_ps(relTol);
+      for( ; i + 4 <= n; i += 4 )
       {
-         for( auto & tc : i.second.m_tcs )
-         {
-            if( !tc.second.m_disabled )
-            {
-               ts_OK += tc.second.m_ts_OK;
-               ts_FAIL += tc.second.m_ts_FAIL;
-            }
-         }
+         const __m128 x = _mm_loadu_ps(a + i);
+         const __m128 y = _mm_loadu_ps(b + i);
+         const __m128 d = _mm_andnot_ps(sign, _mm_sub_ps(x, y));
+         const __m128 m = _mm_max_ps(_mm_andnot_ps(sign, x), _mm_andnot_ps(sign, y));
+         const __m128 ok = _mm_or_ps(_mm_cmpeq_ps(x, y),
+                                     _mm_or_ps(_mm_cmple_ps(d, at), _mm_cmple_ps(d, _mm_mul_ps(rt, m))));
+         c += 4 - __builtin_popcount(_mm_movemask_ps(ok));
       }
+      return c;
+   }
 
-      int ts_exec = ts_OK + ts_FAIL;
+   size_t countNearSSE( const double * a, const double * b, size_t n, double absTol, double relTol, size_t & i )
+   {
+      size_t c = 0;
+      const __m128d sign = _mm_set1_pd(-0.0);
+      const __m128d at = _mm_set1_pd(absTol);
+      const __m128d rt = _mm_set1_pd(relTol);
+      for( ; i + 2 <= n; i += 2 )
+      {
+         const __m128d x = _mm_loadu_pd(a + i);
+         const __m128d y = _mm_loadu_pd(b + i);
+         const __m128d d = _mm_andnot_pd(sign, _mm_sub_pd(x, y));
+         const __m128d m = _mm_max_pd(_mm_andnot_pd(sign, x), _mm_andnot_pd(sign, y));
+         const __m128d ok = _mm_or_pd(_mm_cmpeq_pd(x, y),
+                                      _mm_or_pd(_mm_cmple_pd(d, at), _mm_cmple_pd(d, _mm_mul_pd(rt, m))));
+         c += 2 - __builtin_popcount(_mm_movemask_pd(ok));
+      }
+      return c;
+   }
+#endif
 
-      if( ts_exec < 1 )
+   // number of elements that are neither equal nor within the tolerance
+   template <typename T>
+   size_t countNear( const T * a, const T * b, size_t n, T absTol, T relTol )
+   {
+      size_t c = 0;
+      size_t i = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+      static const bool avx = __builtin_cpu_supports("avx");
+      if( avx )
       {
-         cout << "BAD: NO teststeps were exec'd..." << endl;
-         return;
+         c += countNearAVX(a, b, n, absTol, relTol, i);
       }
+      c += countNearSSE(a, b, n, absTol, relTol, i);
+#endif
 
-      cout << "    exec'd  : \t" << ts_exec << endl;
-      cout << "     OK     : \t" << ts_OK << "\t" <<  ts_OK * 100 / ts_exec  << "%" << endl;
-      cout << "     FAILED : \t" << ts_FAIL << "\t" <<  ts_FAIL * 100 / ts_exec << "%" << endl;
-      if( tc_FAIL > 0 )
+      for( ; i < n; ++i )
       {
-         cout << "=====================================\n";
-         cout << "======  B A D  ======================\n";
-         cout << "=====================================";
-      } else {
-         cout << "======  O K  ========================";
+         c += !isNear(a[i], b[i], absTol, relTol);
       }
-      cout << endl;
+      return c;
    }
 
-   const char * const s_html[] = {
+   template <typename T, typename Count, typename Match>
+   size_t rangeBlocks( const T * a, const T * b, size_t n,
+                       vector<size_t> & idx, size_t maxIdx,
+                       Count count, Match match )
+   {
+      size_t total = 0;
 
-      "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Strict//EN\" \"http://www.w3.org/TR/xhtml1/DTD/xhtml1-strict.dtd\">",
-      "<html xmlns=\"http://www.w3.org/1999/xhtml\" xml:lang=\"en\" lang=\"en\">",
-      "<head>",
-      "  <meta http-equiv=\"content-type\" content=\"text/html; charset=utf-8\" />",
-      "  <meta name=\"generator\" content=\"CPP11UT - http://redmine.x64it.com/projects/cpp11ut1\" />",
-      "  <title>$TITLE$ - UT Results</title>",
-      "",
-      "  <style type=\"text/css\" media=\"screen\">",
-      "    <!--",
-      "    hr  {",
-      "      width: 99%;",
-      "      border-width: 0px;",
-      "      height: 3px;",
-      "      color: #ccbbcc;",
-      "      background-color: #cc33cc;",
-      "      padding: 0px;",
-      "    }",
-      "",
-      "    table {",
-      "      width:100%;",
-      "      border-collapse:separate;",
-      "      border-spacing: 2px;",
-      "      border:0px;",
-      "    }",
-      "    tr {",
-      "      margin:0px;",
-      "      padding:0px;",
-      "    }",
-      "    td {",
-      "      margin:0px;",
-      "      padding:1px;",
-      "    }",
-      "    .table_summary {",
-      "      background-color: #b0b0b0;",
-      "    }",
-      "    .table_suites {",
-      "      background-color: #b0b0b0;",
-      "    }",
-      "    .table_suite {",
-      "      background-color: #b0b0b0;",
-      "    }",
-      "    .table_result {",
-      "      background-color: #b0b0b0;",
-      "      margin: 0px 0px 1em 0px;",
-      "    }",
-      "    .tablecell_title {",
-      "      background-color: #a5cef7;",
-      "      font-weight: bold;",
-      "      text-align: center;",
-      "    }",
-      "",
-      "    .tablecell_success {",
-      "      background-color: #efefe7;",
-      "      text-align: center;",
-      "    }",
-      "",
-      "    .tablecell_left {",
-      "      background-color: #efefe7;",
-      "      text-align: left;",
-      "    }",
-      "",
-      "    .tablecell_lefterror {",
-      "      color: #ff0808;",
-      "      background-color: #efbfe7;",
-      "      font-weight: bold;",
-      "      text-align: left;",
-      "    }",
-      "",
-      "    .tablecell_warn {",
-      "      background-color: #ffff80;",
-      "      text-align: center;",
-      "    }",
-      "",
-      "    .tablecell_error {",
-      "      color: #ff0808;",
-      "      background-color: #efbfe7;",
-      "      font-weight: bold;",
-      "      text-align: center;",
-      "    }",
-      "    p.spaced {",
-      "      margin: 0px;",
-      "      padding: 3px 0px 3px 0px;",
-      "    }",
-      "    p.unspaced {",
-      "      margin: 0px;",
-      "      padding: 0px 0px 2em 0px;",
-      "    }",
-      "    -->",
-      "  </style>",
-      "</head>",
-      "",
-      "<body>",
-      "",
-      "<table>",
-      " <tr>",
-      "  <td>",
-      "   <h1><a name=\"top\"></a>$TITLE$ - Unit Tests Results</h1>",
-      "  </td>",
-      "  <td>",
-      "   <div style=\"text-align:right\">",
-      "    <a href=\"http://redmine.x64it.com/projects/cpp11ut1\">CPP11UT</a> v0.2 &copy; 2013",
-      "   </div>",
-      "   <div style=\"text-align:right\">",
-      "    by Andreas Boerner",
-      "   </div>",
-      "  </td>",
-      " </tr>",
-      "</table>",
-      "$GTIME$",
-      "<hr />",
-      "",
-      "<h2>Summary</h2>",
+      for( size_t i = 0; i < n; i += RangeBlock )
+      {
+         const size_t len = min(RangeBlock, n - i);
+         const size_t c = count(a + i, b + i, len);
+
+         for( size_t j = i; c > 0 && j < i + len && idx.size() < maxIdx; ++j )
+         {
+            if( !match(a[j], b[j]) )
+            {
+               idx.push_back(j);
+            }
+         }
+
+         total += c;
+      }
+
+      return total;
+   }
+
+   // fuzzing (--fuzz) -----------------------------------------------
+
+   // edge coverage, filled by the -fsanitize-coverage callbacks at the end of
+   // this file when the code under test is instrumented (see 'make fuzz')
+   const size_t CovSize = 1 << 16;
+   alignas(8) unsigned char s_cov[CovSize];
+   // the entries that went from 0 to 1 since the last update(): only they are read and cleared
+   uint16_t s_cov_touched[CovSize];
+   size_t s_cov_ntouched = 0;
+   bool s_cov_used = false;
+   thread_local uintptr_t t_cov_prev = 0;
+
+   // AFL style classes of hit counts
+   inline unsigned char covBucket( unsigned char c )
+   {
+      if( c == 0 )   return 0;
+      if( c < 4 )    return 1 << (c - 1);
+      if( c < 8 )    return 8;
+      if( c < 16 )   return 16;
+      if( c < 32 )   return 32;
+      if( c < 128 )  return 64;
+      return 128;
+   }
+
+   class Coverage
+   {
+      public:
+         Coverage() : m_seen(CovSize, 0), m_edges(0) {};
+
+         // true, if the last execution reached a new edge (or hit count class)
+         bool update()
+         {
+            bool news = false;
+            const size_t n = min(s_cov_ntouched, CovSize);
+
+            for( size_t k = 0; k < n; ++k )
+            {
+               const size_t j = s_cov_touched[k];
+               unsigned char b = covBucket(s_cov[j]);
+               s_cov[j] = 0;
+               if( b & ~m_seen[j] )
+               {
+                  m_edges += m_seen[j] == 0;
+                  m_seen[j] |= b;
+                  news = true;
+               }
+            }
+
+            s_cov_ntouched = 0;
+            return news;
+         }
+
+         void clear()
+         {
+            const size_t n = min(s_cov_ntouched, CovSize);
+            for( size_t k = 0; k < n; ++k )
+            {
+               s_cov[s_cov_touched[k]] = 0;
+            }
+            s_cov_ntouched = 0;
+         }
+
+         size_t edges() const { return m_edges; }
+
+      private:
+         vector<unsigned char> m_seen;
+         size_t m_edges;
+   };
+
+   // mutates the input bytes argument by argument, following the layout of the FUZZ_TEST
+   class Mutator
+   {
+      public:
+         Mutator( const vector<UT::FuzzSlot> & layout, uint64_t seed ) : m_layout(layout), m_state(seed | 1) {};
+
+         vector<unsigned char> mutate( const vector<unsigned char> & in,
+                                       const vector< vector<unsigned char> > & corpus )
+         {
+            auto slots = split(in);
+
+            if( slots.empty() )
+            {
+               return in;
+            }
+
+            for( int n = 1 + rnd() % 3; n > 0; --n )
+            {
+               const size_t i = rnd() % slots.size();
+
+               if( m_layout[i].m_kind == UT::FUZZ_STRING )
+               {
+                  mutateString(slots[i]);
+               } else {
+                  mutateNumber(i, slots);
+               }
+
+               // cross-over: take the argument from another corpus entry
+               if( rnd() % 8 == 0 )
+               {
+                  auto other = split(corpus[rnd() % corpus.size()]);
+                  const size_t k = rnd() % slots.size();
+                  slots[k] = other[k];
+               }
+            }
+
+            return join(slots);
+         }
+
+         vector<unsigned char> seed() const
+         {
+            vector< vector<unsigned char> > slots;
+            for( auto & sl : m_layout )
+            {
+               slots.push_back( vector<unsigned char>( sl.m_kind == UT::FUZZ_STRING ? 1 : sl.m_size, 0 ) );
+            }
+            return join(slots);
+         }
+
+         uint64_t rnd()
+         {
+            // xorshift64*
+            m_state ^= m_state >> 12;
+            m_state ^= m_state << 25;
+            m_state ^= m_state >> 27;
+            return m_state * 2685821657736338717ULL;
+         }
+
+      private:
+         vector< vector<unsigned char> > split( const vector<unsigned char> & in ) const
+         {
+            vector< vector<unsigned char> > slots;
+            size_t pos = 0;
+
+            for( auto & sl : m_layout )
+            {
+               size_t len = sl.m_size;
+               if( sl.m_kind == UT::FUZZ_STRING )
+               {
+                  len = 1 + (pos < in.size() ? in[pos] : 0);
+               }
+
+               vector<unsigned char> v(len, 0);
+               for( size_t i = 0; i < len && pos < in.size(); ++i )
+               {
+                  v[i] = in[pos++];
+               }
+
+               if( sl.m_kind == UT::FUZZ_STRING )
+               {
+                  v[0] = len - 1;
+               }
+
+               slots.push_back(v);
+            }
+
+            return slots;
+         }
+
+         vector<unsigned char> join( const vector< vector<unsigned char> > & slots ) const
+         {
+            vector<unsigned char> out;
+            for( auto & v : slots )
+            {
+               out.insert(out.end(), v.begin(), v.end());
+            }
+            return out;
+         }
+
+         void setNumber( vector<unsigned char> & v, UT::FuzzKind kind, double value )
+         {
+            if( kind == UT::FUZZ_FLOAT && v.size() == sizeof(float) )
+            {
+               float f = value;
+               memcpy(v.data(), &f, sizeof(f));
+            } else if( kind == UT::FUZZ_FLOAT && v.size() == sizeof(double) ) {
+               memcpy(v.data(), &value, sizeof(value));
+            } else if( kind == UT::FUZZ_FLOAT ) {
+               long double ld = value;
+               memcpy(v.data(), &ld, min(v.size(), sizeof(ld)));
+            } else {
+               // little endian, two's complement
+               long long l = value;
+               memcpy(v.data(), &l, min(v.size(), sizeof(l)));
+            }
+         }
+
+         double getNumber( const vector<unsigned char> & v, UT::FuzzKind kind )
+         {
+            if( kind == UT::FUZZ_FLOAT && v.size() == sizeof(float) )
+            {
+               float f;
+               memcpy(&f, v.data(), sizeof(f));
+               return f;
+            } else if( kind == UT::FUZZ_FLOAT && v.size() == sizeof(double) ) {
+               double d;
+               memcpy(&d, v.data(), sizeof(d));
+               return d;
+            }
+
+            long long l = 0;
+            memcpy(&l, v.data(), min(v.size(), sizeof(l)));
+            return l;
+         }
+
+         void mutateNumber( size_t i, vector< vector<unsigned char> > & slots )
+         {
+            static const double interesting[] = {
+               0.0, -0.0, 1.0, -1.0, 0.5, 2.0, 1e-7, -1e-7, 1e-6, 127.0, 128.0, 255.0, 256.0,
+               32767.0, 65535.0, 2147483647.0, -2147483648.0, 4294967295.0,
+               numeric_limits<double>::infinity(), -numeric_limits<double>::infinity(),
+               numeric_limits<double>::quiet_NaN(), numeric_limits<float>::max(),
+               numeric_limits<float>::min(), numeric_limits<float>::denorm_min() };
+
+            vector<unsigned char> & v = slots[i];
+            const UT::FuzzKind kind = m_layout[i].m_kind;
+
+            switch( rnd() % 7 )
+            {
+               case 0: // flip a bit
+                  v[rnd() % v.size()] ^= 1 << (rnd() % 8);
+                  break;
+               case 1: // random bytes
+                  for( auto & c : v ) c = rnd();
+                  break;
+               case 2: // small integer; most branches compare against those
+                  setNumber(v, kind, static_cast<int>(rnd() % 129) - 64);
+                  break;
+               case 3: // the value of another argument of the same type
+               {
+                  const size_t k = rnd() % slots.size();
+                  if( m_layout[k].m_kind == kind && slots[k].size() == v.size() )
+                  {
+                     v = slots[k];
+                  }
+                  break;
+               }
+               case 4:
+                  setNumber(v, kind, interesting[rnd() % (sizeof(interesting) / sizeof(interesting[0]))]);
+                  break;
+               case 5: // small step
+                  setNumber(v, kind, getNumber(v, kind) + static_cast<int>(rnd() % 33) - 16);
+                  break;
+               default: // flip the sign
+                  setNumber(v, kind, -getNumber(v, kind));
+                  break;
+            }
+         }
+
+         void mutateString( vector<unsigned char> & v )
+         {
+            // v[0] is the length
+            string s(v.begin() + 1, v.end());
+
+            switch( rnd() % 4 )
+            {
+               case 0:
+                  if( s.size() < 255 ) s.insert(s.begin() + rnd() % (s.size() + 1), static_cast<char>(rnd()));
+                  break;
+               case 1:
+                  if( !s.empty() ) s.erase(s.begin() + rnd() % s.size());
+                  break;
+               case 2:
+                  if( !s.empty() ) s[rnd() % s.size()] ^= 1 << (rnd() % 8);
+                  break;
+               default:
+                  s.assign(rnd() % 33, ' ');
+                  for( auto & c : s ) c = static_cast<char>(32 + rnd() % 95);
+                  break;
+            }
+
+            v.assign(1, static_cast<unsigned char>(s.size()));
+            v.insert(v.end(), s.begin(), s.end());
+         }
+
+         vector<UT::FuzzSlot> m_layout;
+         uint64_t m_state;
+   };
+
+   string hexHash( const vector<unsigned char> & data )
+   {
+      // FNV-1a
+      uint64_t h = 14695981039346656037ULL;
+      for( auto c : data )
+      {
+         h = (h ^ c) * 1099511628211ULL;
+      }
+      ostringstream oss;
+      oss << hex << setfill('0') << setw(16) << h;
+      return oss.str();
+   }
+
+   void makeDirs( const string & path )
+   {
+      for( size_t pos = path.find('/', 1); pos != string::npos; pos = path.find('/', pos + 1) )
+      {
+         ::mkdir(path.substr(0, pos).c_str(), 0774);
+      }
+      ::mkdir(path.c_str(), 0774);
+   }
+
+   vector<string> listDir( const string & path )
+   {
+      vector<string> files;
+      DIR * dir = opendir(path.c_str());
+      if( dir == nullptr )
+      {
+         return files;
+      }
+
+      while( dirent * e = readdir(dir) )
+      {
+         if( e->d_name[0] != '.' )
+         {
+            files.push_back(e->d_name);
+         }
+      }
+      closedir(dir);
+
+      sort(files.begin(), files.end());
+      return files;
+   }
+
+   vector<unsigned char> readFile( const string & path )
+   {
+      ifstream in(path, ios::binary);
+      return vector<unsigned char>( (istreambuf_iterator<char>(in)), istreambuf_iterator<char>() );
+   }
+
+   void writeFile( const string & path, const vector<unsigned char> & data )
+   {
+      ofstream out(path, ios::binary);
+      out.write(reinterpret_cast<const char *>(data.data()), data.size());
+   }
+
+   // state of the FUZZ_TEST execution of this thread; test steps only count
+   struct FuzzRun
+   {
+         int m_steps = 0;
+         string m_sig = "";    // signature of the first failure
+   };
+
+   thread_local FuzzRun * t_fuzz = nullptr;
+
+   // signal recovery (--catch-signals) ------------------------------
+
+   const int s_signals[] = { SIGSEGV, SIGFPE, SIGABRT, SIGBUS, SIGILL };
+
+   // per thread: where to jump back to and what happened
+   struct Guard
+   {
+         sigjmp_buf m_jmp;
+         volatile sig_atomic_t m_armed = 0;
+         volatile sig_atomic_t m_sig = 0;
+         void * m_frames[64];
+         int m_nframes = 0;
+         bool m_altstack = false;
+   };
+
+   thread_local Guard t_guard;
+
+   void rescueCapture();
+
+   void crashHandler( int sig, siginfo_t *, void * )
+   {
+      if( !t_guard.m_armed )
+      {
+         // not inside a test (or another thread): die as without the handler,
+         // but show what --capture held back first
+         rescueCapture();
+         signal(sig, SIG_DFL);
+         raise(sig);
+         return;
+      }
+
+      t_guard.m_armed = 0;
+      t_guard.m_sig = sig;
+      t_guard.m_nframes = backtrace(t_guard.m_frames, 64);
+      siglongjmp(t_guard.m_jmp, 1);
+   }
+
+   void installCrashHandler()
+   {
+      // the first backtrace() loads libgcc; not in the signal handler
+      void * dummy[1];
+      backtrace(dummy, 1);
+
+      struct sigaction sa;
+      memset(&sa, 0, sizeof(sa));
+      sa.sa_sigaction = crashHandler;
+      sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+      sigemptyset(&sa.sa_mask);
+
+      for( auto sig : s_signals )
+      {
+         sigaction(sig, &sa, nullptr);
+      }
+   }
+
+   // each thread needs its own stack for the handler; a stack overflow leaves none
+   void altStack()
+   {
+      if( t_guard.m_altstack )
+      {
+         return;
+      }
+
+      static thread_local vector<char> mem(64 * 1024);
+      stack_t st;
+      st.ss_sp = mem.data();
+      st.ss_size = mem.size();
+      st.ss_flags = 0;
+      sigaltstack(&st, nullptr);
+      t_guard.m_altstack = true;
+   }
+
+   // runs f; the signal number if it crashed, else 0. Destructors of f's
+   // locals are skipped after a crash, what they own is lost.
+   int guarded( const function<void (void)> & f )
+   {
+      altStack();
+
+      if( sigsetjmp(t_guard.m_jmp, 1) != 0 )
+      {
+         return t_guard.m_sig;
+      }
+
+      t_guard.m_sig = 0;
+      t_guard.m_armed = 1;
+
+      try
+      {
+         f();
+      }
+      catch(...)
+      {
+         t_guard.m_armed = 0;
+         throw;
+      }
+
+      t_guard.m_armed = 0;
+      return 0;
+   }
+
+   string signalName( int sig )
+   {
+      switch( sig )
+      {
+         case SIGSEGV: return "SIGSEGV";
+         case SIGFPE:  return "SIGFPE";
+         case SIGABRT: return "SIGABRT";
+         case SIGBUS:  return "SIGBUS";
+         case SIGILL:  return "SIGILL";
+      }
+      return "signal " + to_string(sig);
+   }
+
+   // "function at file:line" by addr2line (if installed and the binary has debug info)
+   string addr2line( void * frame )
+   {
+      Dl_info info;
+      if( dladdr(frame, &info) == 0 || info.dli_fname == nullptr )
+      {
+         return "";
+      }
+
+      // return addresses point behind the call
+      const uintptr_t offset = reinterpret_cast<uintptr_t>(frame) - reinterpret_cast<uintptr_t>(info.dli_fbase) - 1;
+
+      ostringstream cmd;
+      cmd << "addr2line -f -C -e '" << info.dli_fname << "' 0x" << hex << offset << " 2>/dev/null";
+
+      FILE * f = popen(cmd.str().c_str(), "r");
+      if( f == nullptr )
+      {
+         return "";
+      }
+
+      char func[512] = "";
+      char where[512] = "";
+      const bool ok = fgets(func, sizeof(func), f) != nullptr && fgets(where, sizeof(where), f) != nullptr;
+      pclose(f);
+
+      string fn(func);
+      string wh(where);
+      fn.erase(fn.find_last_not_of("\n") + 1);
+      wh.erase(wh.find_last_not_of("\n") + 1);
+
+      if( !ok || wh.compare(0, 2, "??") == 0 )
+      {
+         return "";
+      }
+      return fn + " at " + wh;
+   }
+
+   // the frames of the last crash of this thread, demangled; one per line
+   string crashBacktrace()
+   {
+      ostringstream oss;
+      char ** symbols = backtrace_symbols(t_guard.m_frames, t_guard.m_nframes);
+      if( symbols == nullptr )
+      {
+         return "";
+      }
+
+      // frame 0 is the handler, 1 the signal trampoline
+      for( int i = 2; i < t_guard.m_nframes; ++i )
+      {
+         // "binary(mangled+0x12) [0x...]"
+         string line = symbols[i];
+         const auto open = line.find('(');
+         const auto plus = line.find('+', open);
+         if( open != string::npos && plus != string::npos && plus > open + 1 )
+         {
+            int status;
+            const string mangled = line.substr(open + 1, plus - open - 1);
+            char * name = abi::__cxa_demangle(mangled.c_str(), 0, 0, &status);
+            if( name != nullptr )
+            {
+               line.replace(open + 1, plus - open - 1, name);
+               free(name);
+            }
+         }
+
+         // nothing interesting below the test function
+         if( line.find("guarded") != string::npos )
+         {
+            break;
+         }
+
+         const string src = addr2line(t_guard.m_frames[i]);
+         const string frame = src.size() > 0 ? src : line;
+
+         // the std::function machinery calling the EXEC lambda
+         if( frame.find("std::__invoke") != string::npos || frame.find("std::_Function_handler") != string::npos )
+         {
+            break;
+         }
+
+         oss << "#" << i - 2 << " " << frame << "\n";
+      }
+
+      free(symbols);
+      return oss.str();
+   }
+
+   // fixtures ---------------------------------------------------------
+
+   // the testcase running in this thread and the fixture setup time it spent
+   thread_local const UT::Probe * t_probe = nullptr;
+   thread_local double t_setup_time = 0.0;
+
+   // the VirtualClock of the testcase running in this thread; outside of one, t_idle
+   thread_local UT::ClockState * t_clock = nullptr;
+   thread_local UT::ClockState t_idle;
+
+   struct ClockScope
+   {
+         explicit ClockScope( UT::ClockState & c )
+         {
+            t_clock = &c;
+         }
+
+         ClockScope(const ClockScope &) = delete;
+         ClockScope & operator=(const ClockScope &) = delete;
+
+         ~ClockScope()
+         {
+            t_clock = nullptr;
+         }
+   };
+
+   UT::ClockState & clockState()
+   {
+      return t_clock != nullptr ? *t_clock : t_idle;
+   }
+
+   bool inScope( const string & scope, const string & tpath )
+   {
+      if( scope.empty() )
+      {
+         return true;
+      }
+      return tpath.compare(0, scope.size(), scope) == 0 &&
+             (tpath.size() == scope.size() || scope.back() == '/' || tpath[scope.size()] == '/');
+   }
+
+   double seconds( const timespec & t1, const timespec & t2 )
+   {
+      const timespec d = diff(t1, t2);
+      return d.tv_sec + d.tv_nsec / 1000000000.0;
+   }
+
+   double seconds( const timespec & t )
+   {
+      return t.tv_sec + t.tv_nsec / 1000000000.0;
+   }
+
+   // --capture ---------------------------------------------------------
+
+   // unbuffered output to a file descriptor
+   class FdBuf : public streambuf
+   {
+      public:
+         explicit FdBuf( int fd ) : m_fd(fd)
+         {
+         }
+
+      protected:
+         int_type overflow( int_type c ) override
+         {
+            if( !traits_type::eq_int_type(c, traits_type::eof()) )
+            {
+               const char ch = traits_type::to_char_type(c);
+               put(&ch, 1);
+            }
+            return traits_type::not_eof(c);
+         }
+
+         streamsize xsputn( const char * s, streamsize n ) override
+         {
+            put(s, n);
+            return n;
+         }
+
+      private:
+         void put( const char * s, size_t n )
+         {
+            while( n > 0 )
+            {
+               const ssize_t w = write(m_fd, s, n);
+               if( w < 0 && errno == EINTR )
+               {
+                  continue;
+               }
+               if( w <= 0 )
+               {
+                  return;
+               }
+               s += w;
+               n -= w;
+            }
+         }
+
+         int m_fd;
+   };
+
+   // what a testcase printed, the first m_limit bytes of it
+   struct Output
+   {
+         string m_text = "";
+         size_t m_dropped = 0;
+         bool m_shared = false;     // -j: may hold what other testcases printed at the same time
+         unsigned long m_starts = 0;
+         off_t m_from = 0;          // the memfd up to here is in m_text
+
+         void add( const char * s, size_t n, size_t limit )
+         {
+            const size_t k = min(n, limit - min(limit, m_text.size()));
+            m_text.append(s, k);
+            m_dropped += n - k;
+         }
+
+         string text() const
+         {
+            string t = m_text;
+            if( m_dropped > 0 )
+            {
+               t += "\n... (" + to_string(m_dropped) + " more bytes)";
+            }
+            if( m_shared && t.size() > 0 )
+            {
+               t += "\n(-j: printf() and write() output of testcases running at the same time may be in it)";
+            }
+            return t;
+         }
+   };
+
+   // the Output of the testcase running in this thread
+   thread_local Output * t_output = nullptr;
+
+   void drainOutput( Output & o );
+
+   // cout and cerr while capturing: into the running testcase, else to the terminal
+   class CaptureBuf : public streambuf
+   {
+      public:
+         CaptureBuf( streambuf * out, size_t limit ) : m_out(out), m_limit(limit)
+         {
+         }
+
+         CaptureBuf(const CaptureBuf &) = delete;
+         CaptureBuf & operator=(const CaptureBuf &) = delete;
+
+      protected:
+         int_type overflow( int_type c ) override
+         {
+            if( traits_type::eq_int_type(c, traits_type::eof()) )
+            {
+               return traits_type::not_eof(c);
+            }
+            if( t_output != nullptr )
+            {
+               const char ch = traits_type::to_char_type(c);
+               drainOutput(*t_output);
+               t_output->add(&ch, 1, m_limit);
+               return c;
+            }
+            return m_out->sputc(traits_type::to_char_type(c));
+         }
+
+         streamsize xsputn( const char * s, streamsize n ) override
+         {
+            if( t_output != nullptr )
+            {
+               drainOutput(*t_output);   // printf() before, in order
+               t_output->add(s, n, m_limit);
+               return n;
+            }
+            return m_out->sputn(s, n);
+         }
+
+         int sync() override
+         {
+            return m_out->pubsync();
+         }
+
+      private:
+         streambuf * m_out;
+         size_t m_limit;
+   };
+
+   // fd 1 and 2 go to a memfd, cout and cerr through CaptureBufs; a testcase
+   // gets the part of the memfd written while it ran
+   struct Capture
+   {
+         int m_fd = -1;               // the memfd
+         int m_out = -1;              // the terminal, fd 1 and 2 before
+         int m_err = -1;
+         size_t m_limit = 64 * 1024;  // per testcase
+
+         unique_ptr<FdBuf> m_out_buf {};
+         unique_ptr<FdBuf> m_err_buf {};
+         unique_ptr<CaptureBuf> m_cout {};
+         unique_ptr<CaptureBuf> m_cerr {};
+         unique_ptr<ostream> m_console {};   // the framework's lines during a testcase
+         streambuf * m_cout_old = nullptr;
+         streambuf * m_cerr_old = nullptr;
+
+         mutex m_mutex {};
+         int m_running = 0;
+         unsigned long m_starts = 0;
+         atomic<off_t> m_shown {0};       // the memfd before it needs no rescue
+         atomic<bool> m_rescued {false};
+
+         void start()
+         {
+            static bool once = false;
+            if( !once )
+            {
+               // a crash, abort() or exit() in a testcase must not lose its output
+               once = true;
+               installCrashHandler();
+               atexit([]() { fflush(stdout); fflush(stderr); rescueCapture(); });
+            }
+
+            cout.flush();
+            cerr.flush();
+            fflush(stdout);
+            fflush(stderr);
+
+            m_fd = memfd_create("ut-capture", MFD_CLOEXEC);
+            if( m_fd < 0 )
+            {
+               throw runtime_error(string("memfd_create: ") + strerror(errno));
+            }
+
+            m_out = dup(1);
+            m_err = dup(2);
+            dup2(m_fd, 1);
+            dup2(m_fd, 2);
+
+            m_out_buf.reset(new FdBuf(m_out));
+            m_err_buf.reset(new FdBuf(m_err));
+            m_cout.reset(new CaptureBuf(m_out_buf.get(), m_limit));
+            m_cerr.reset(new CaptureBuf(m_err_buf.get(), m_limit));
+            m_console.reset(new ostream(m_out_buf.get()));
+            m_cout_old = cout.rdbuf(m_cout.get());
+            m_cerr_old = cerr.rdbuf(m_cerr.get());
+         }
+
+         void stop()
+         {
+            fflush(stdout);
+            fflush(stderr);
+            cout.rdbuf(m_cout_old);
+            cerr.rdbuf(m_cerr_old);
+            dup2(m_out, 1);
+            dup2(m_err, 2);
+            close(m_out);
+            close(m_err);
+            close(m_fd);
+            m_fd = -1;
+            m_console.reset();
+         }
+
+         bool active() const
+         {
+            return m_fd >= 0;
+         }
+
+         off_t size() const
+         {
+            struct stat st;
+            return fstat(m_fd, &st) == 0 ? st.st_size : 0;
+         }
+
+         void begin( Output & o )
+         {
+            fflush(stdout);
+            fflush(stderr);
+
+            lock_guard<mutex> lock(m_mutex);
+            if( m_running == 0 && size() > off_t(16 * m_limit) )
+            {
+               if( ftruncate(m_fd, 0) == 0 )
+               {
+                  lseek(m_fd, 0, SEEK_SET);
+                  m_shown = 0;
+               }
+            }
+
+            o.m_shared = o.m_shared || m_running > 0;
+            m_running++;
+            o.m_starts = ++m_starts;
+            o.m_from = size();
+            t_output = &o;
+         }
+
+         // what fd 1 and 2 got since the last time
+         void drain( Output & o )
+         {
+            fflush(stdout);
+            fflush(stderr);
+
+            const off_t to = size();
+            char buf[4096];
+            while( o.m_from < to )
+            {
+               const ssize_t n = pread(m_fd, buf, min<off_t>(sizeof(buf), to - o.m_from), o.m_from);
+               if( n <= 0 )
+               {
+                  break;
+               }
+               o.add(buf, n, m_limit);
+               o.m_from += n;
+            }
+         }
+
+         void end( Output & o )
+         {
+            t_output = nullptr;
+            drain(o);
+
+            lock_guard<mutex> lock(m_mutex);
+            o.m_shared = o.m_shared || m_running > 1 || m_starts != o.m_starts;
+            m_running--;
+            if( m_running == 0 )
+            {
+               m_shown = size();
+            }
+         }
+
+         // the process dies in a testcase (fatal signal, abort(), exit()): copy what
+         // it printed to the terminal. Only write(), pread() and fstat(): the signal
+         // handler calls it
+         void rescue()
+         {
+            if( m_fd < 0 || m_rescued.exchange(true) )
+            {
+               return;
+            }
+
+            static const char head[] = "\n--- captured output of the running testcase(s) ---\n";
+            put(head, sizeof(head) - 1);
+
+            off_t from = m_shown;
+            if( t_output != nullptr )
+            {
+               // cout and cerr of this thread's testcase, the memfd up to m_from in order
+               put(t_output->m_text.data(), t_output->m_text.size());
+               from = t_output->m_from;
+            }
+
+            const off_t to = size();
+            char buf[4096];
+            while( from < to )
+            {
+               const ssize_t n = pread(m_fd, buf, min<off_t>(sizeof(buf), to - from), from);
+               if( n <= 0 )
+               {
+                  break;
+               }
+               put(buf, n);
+               from += n;
+            }
+         }
+
+         void put( const char * s, size_t n )
+         {
+            while( n > 0 )
+            {
+               const ssize_t w = write(m_err, s, n);
+               if( w < 0 && errno == EINTR )
+               {
+                  continue;
+               }
+               if( w <= 0 )
+               {
+                  return;
+               }
+               s += w;
+               n -= w;
+            }
+         }
+   };
+
+   Capture s_capture;
+
+   void drainOutput( Output & o )
+   {
+      s_capture.drain(o);
+   }
+
+   void rescueCapture()
+   {
+      s_capture.rescue();
+   }
+
+   // the framework's lines in a testcase bypass the capture
+   ostream & console()
+   {
+      return s_capture.m_console ? *s_capture.m_console : cout;
+   }
+
+   double monotonic()
+   {
+      timespec t;
+      clock_gettime(CLOCK_MONOTONIC, &t);
+      return t.tv_sec + t.tv_nsec / 1000000000.0;
+   }
+
+   // the clock of the step times: the TSC if it is invariant (constant_tsc and nonstop_tsc),
+   // calibrated once against CLOCK_MONOTONIC, else CLOCK_MONOTONIC in ns
+   struct StepClock
+   {
+         bool m_tsc = false;
+         double m_seconds = 1e-9;   // per tick
+
+         static const StepClock & get()
+         {
+            static const StepClock c;
+            return c;
+         }
+
+         StepClock()
+         {
+#if defined(__x86_64__) || defined(__i386__)
+            ifstream info("/proc/cpuinfo");
+            string line;
+            while( getline(info, line) )
+            {
+               if( line.compare(0, 5, "flags") == 0 )
+               {
+                  m_tsc = line.find(" constant_tsc") != string::npos && line.find(" nonstop_tsc") != string::npos;
+                  break;
+               }
+            }
+
+            if( m_tsc )
+            {
+               const double t0 = monotonic();
+               const uint64_t c0 = __rdtsc();
+               double t1;
+               while( (t1 = monotonic()) - t0 < 0.02 )
+               {
+               }
+               m_seconds = (t1 - t0) / (__rdtsc() - c0);
+            }
+#endif
+         }
+
+         uint64_t now() const
+         {
+#if defined(__x86_64__) || defined(__i386__)
+            if( m_tsc )
+            {
+               return __rdtsc();
+            }
+#endif
+            timespec t;
+            clock_gettime(CLOCK_MONOTONIC, &t);
+            return t.tv_sec * 1000000000ULL + t.tv_nsec;
+         }
+
+         string name() const
+         {
+            ostringstream oss;
+            if( m_tsc )
+            {
+               oss << "TSC, " << setprecision(4) << 1e-9 / m_seconds << " GHz";
+            } else {
+               oss << "CLOCK_MONOTONIC";
+            }
+            return oss.str();
+         }
+   };
+
+   // when the last step of the testcase in this thread ended (or it started)
+   thread_local uint64_t t_step_mark = 0;
+
+   // --trace: the run as trace events for chrome://tracing or ui.perfetto.dev. Every
+   // thread collects its spans in a buffer of its own; the track (tid) is 0 for the
+   // main thread, j + 1 for worker j (the same in every round), >= 100 for threads
+   // a testcase started
+   thread_local int t_trace_tid = -1;
+
+   class Tracer
+   {
+      public:
+         struct Event
+         {
+               string m_name;
+               const char * m_cat;
+               double m_begin;   // CLOCK_MONOTONIC
+               double m_end;
+               int m_tid;
+               long m_id;        // > 0: an async span, may overlap others of its track
+               string m_args;    // JSON members, e.g. "\"ok\":true"
+         };
+
+         bool m_on = false;
+
+         void track( int tid )
+         {
+            t_trace_tid = tid;
+         }
+
+         void span( const string & name, const char * cat, double begin, double end,
+                    const string & args = "", bool async = false )
+         {
+            if( !m_on )
+            {
+               return;
+            }
+            vector<Event> & buf = buffer();
+            buf.push_back(Event{ name, cat, begin, end, t_trace_tid, async ? ++m_ids : 0, args });
+         }
+
+         void write( const string & file )
+         {
+            lock_guard<mutex> lock(m_mutex);
+
+            double origin = numeric_limits<double>::max();
+            set<int> tids;
+            for( auto & b : m_buffers )
+            {
+               for( auto & e : *b )
+               {
+                  origin = min(origin, e.m_begin);
+                  tids.insert(e.m_tid);
+               }
+            }
+
+            auto us = [origin](double t) { return static_cast<long long>((t - origin) * 1e6 + 0.5); };
+
+            ofstream of(file);
+            of << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+               << "{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"process_name\",\"args\":{\"name\":\"" << jsonEscape(m_process) << "\"}}";
+            for( int tid : tids )
+            {
+               const string name = tid == 0 ? "main" : tid < 100 ? "worker " + to_string(tid - 1) : "thread " + to_string(tid - 100);
+               of << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << name << "\"}}"
+                  << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":" << tid << "}}";
+            }
+
+            for( auto & b : m_buffers )
+            {
+               for( auto & e : *b )
+               {
+                  const string common = "\"name\":\"" + jsonEscape(e.m_name) + "\",\"cat\":\"" + e.m_cat
+                                      + "\",\"pid\":1,\"tid\":" + to_string(e.m_tid);
+                  const string args = ",\"args\":{" + e.m_args + "}";
+                  if( e.m_id > 0 )
+                  {
+                     of << ",\n{\"ph\":\"b\"," << common << ",\"id\":" << e.m_id << ",\"ts\":" << us(e.m_begin) << args << "}"
+                        << ",\n{\"ph\":\"e\"," << common << ",\"id\":" << e.m_id << ",\"ts\":" << us(e.m_end) << "}";
+                  } else {
+                     of << ",\n{\"ph\":\"X\"," << common << ",\"ts\":" << us(e.m_begin)
+                        << ",\"dur\":" << max(0LL, us(e.m_end) - us(e.m_begin)) << args << "}";
+                  }
+               }
+            }
+            of << "\n]}\n";
+         }
+
+         string m_process = "ut";
+
+      private:
+         // registered once per thread, kept until write(): threads end before
+         vector<Event> & buffer()
+         {
+            thread_local vector<Event> * buf = nullptr;
+            if( buf == nullptr )
+            {
+               lock_guard<mutex> lock(m_mutex);
+               m_buffers.emplace_back(new vector<Event>);
+               buf = m_buffers.back().get();
+               if( t_trace_tid < 0 )
+               {
+                  t_trace_tid = 100 + m_threads++;
+               }
+            }
+            return *buf;
+         }
+
+         mutex m_mutex {};
+         vector< unique_ptr< vector<Event> > > m_buffers {};
+         int m_threads = 0;
+         atomic<long> m_ids {0};
+   };
+
+   Tracer s_tracer;
+
+   // a framework phase on the track of the calling thread
+   struct TraceSpan
+   {
+         const char * m_name;
+         double m_begin;
+
+         explicit TraceSpan( const char * name ) : m_name(name), m_begin(monotonic())
+         {
+         }
+
+         TraceSpan( const TraceSpan & ) = delete;
+         TraceSpan & operator=( const TraceSpan & ) = delete;
+
+         ~TraceSpan()
+         {
+            s_tracer.span(m_name, "phase", m_begin, monotonic());
+         }
+   };
+}
+
+// ASYNC_TEST ---------------------------------------------------------
+namespace UT {
+
+   // the event loop the ASYNC_TESTs of a round share, single threaded
+   struct AsyncLoop
+   {
+         struct Timer
+         {
+               double m_at;
+               size_t m_seq;       // first come first served at the same time
+               Async * m_as;
+               function<void (void)> m_func;
+
+               bool operator>( const Timer & t ) const
+               {
+                  return m_at > t.m_at || (m_at == t.m_at && m_seq > t.m_seq);
+               }
+         };
+
+         explicit AsyncLoop( bool signals ) :
+            m_epfd(epoll_create1(EPOLL_CLOEXEC)),
+            m_signals(signals)
+         {
+            if( m_epfd < 0 )
+            {
+               throw runtime_error(string("epoll_create1: ") + strerror(errno));
+            }
+         }
+
+         AsyncLoop(const AsyncLoop &) = delete;
+         AsyncLoop & operator=(const AsyncLoop &) = delete;
+
+         ~AsyncLoop()
+         {
+            close(m_epfd);
+         }
+
+         // a piece of a testcase: its body or one of its callbacks
+         void call( Async & as, const function<void (void)> & f )
+         {
+            t_probe = &as.m_probe;
+            t_setup_time = 0.0;
+            t_step_mark = StepClock::get().now();
+            ClockScope clock(as.m_clock);
+            Output & out = m_outputs[&as];
+            if( s_capture.active() )
+            {
+               s_capture.begin(out);
+            }
+
+            try
+            {
+               const int sig = m_signals ? guarded(f) : (f(), 0);
+               if( sig != 0 )
+               {
+                  as.m_sig = sig;
+                  as.m_backtrace = crashBacktrace();
+                  as.done();
+               }
+            }
+            catch(...)
+            {
+               as.fail(current_exception());
+            }
+
+            if( s_capture.active() )
+            {
+               s_capture.end(out);
+            }
+            as.m_setup_time += t_setup_time;
+            t_probe = nullptr;
+
+            // done() inside a callback: the rest of the callback still counts
+            while( m_finished.size() > 0 )
+            {
+               Async * a = m_finished.back();
+               m_finished.pop_back();
+               complete(*a);
+            }
+         }
+
+         void complete( Async & as )
+         {
+            for( auto fd : as.m_fds )
+            {
+               epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr);
+               m_watch.erase(fd);
+            }
+            as.m_fds.clear();
+
+            if( as.m_cancel )
+            {
+               auto cancel = move(as.m_cancel);
+               as.m_cancel = nullptr;
+               cancel();
+            }
+
+            m_open--;
+            m_complete(as);
+         }
+
+         // runs the due timers, then waits for the next timer or fd
+         void once()
+         {
+            double now = monotonic();
+            while( m_timers.size() > 0 && m_timers.front().m_at <= now )
+            {
+               pop_heap(m_timers.begin(), m_timers.end(), greater<Timer>());
+               Timer t = move(m_timers.back());
+               m_timers.pop_back();
+               if( !t.m_as->m_done )
+               {
+                  call(*t.m_as, t.m_func);
+               }
+               now = monotonic();
+            }
+
+            if( m_open == 0 )
+            {
+               return;
+            }
+
+            int wait = -1;
+            if( m_timers.size() > 0 )
+            {
+               wait = max(0, int(ceil((m_timers.front().m_at - now) * 1000.0)));
+            }
+
+            epoll_event ev[256];
+            const int n = epoll_wait(m_epfd, ev, 256, wait);
+            if( n < 0 && errno != EINTR )
+            {
+               throw runtime_error(string("epoll_wait: ") + strerror(errno));
+            }
+
+            for( int i = 0; i < n; ++i )
+            {
+               auto w = m_watch.find(ev[i].data.fd);
+               if( w == m_watch.end() )
+               {
+                  continue;   // off() by an earlier callback
+               }
+
+               // a copy: the callback may off() itself
+               const auto f = w->second.second;
+               const uint32_t events = ev[i].events;
+               call(*w->second.first, [&]() { f(events); });
+            }
+         }
+
+         int m_epfd;
+         bool m_signals;
+         size_t m_open = 0;        // started, not yet complete
+         size_t m_seq = 0;
+         map< int, pair< Async *, function<void (uint32_t)> > > m_watch {};
+         vector<Timer> m_timers {};                   // a min-heap
+         vector<Async *> m_finished {};
+         map<Async *, Output> m_outputs {};           // --capture
+         function<void (Async &)> m_complete {};      // the Manager's bookkeeping
+   };
+}
+
+namespace {
+
+   // END: framework stuff ----------------------------------------
+
+   void step_failed_isTrue(UT::Probe & probe,
+                           const string & exprStr);
+
+   template <typename T>
+   struct myLambdaMap {
+         typedef std::map<std::string, T> type;
+   };
+
+   struct Teststep
+   {
+         bool m_OK = false;
+
+         int m_counter = -1;
+         string m_desc = "";
+         string m_msg = "";
+         string m_EX_expected = "";
+         string m_EX_happened = "";
+         string m_what = "";
+
+         string m_expect = "";
+         string m_actual = "";
+         string m_backtrace = "";   // crash with --catch-signals
+         string m_step = "";        // the expression, if known
+         double m_time = 0.0;       // since the previous step (or the start)
+
+         string dump()
+         {
+            ostringstream oss;
+            oss << "\t\t\t\tTeststep.m_OK          : " << boolalpha << m_OK << "\n"
+                << "\t\t\t\tTeststep.m_counter     : " << m_counter << "\n"
+                << "\t\t\t\tTeststep.m_desc        : " << m_desc << "\n"
+                << "\t\t\t\tTeststep.m_msg         : " << m_msg << "\n"
+                << "\t\t\t\tTeststep.m_expect      : " << m_expect << "\n"
+                << "\t\t\t\tTeststep.m_actual      : " << m_actual << "\n";
+
+            oss << "\t\t\t\tTeststep.m_EX_expected    : " << m_EX_expected << "\n";
+            oss << "\t\t\t\tTeststep.m_EX_happened    : " << m_EX_happened << "\n";
+
+            return oss.str();
+         };
+   };
+
+
+   struct Testcase
+   {
+         string m_name = "";
+         string m_tpath = "";
+         string m_group = "";      // name of the TEST_PARAM, if this is one of its rows
+         int m_disabled = false;
+         int m_ts_OK = 0;
+         int m_ts_FAIL = 0;
+
+         string m_expected = "";
+         string m_actual = "";
+
+         bool m_is_EX_expected = false;
+         bool m_is_EX_happened = false;
+         string m_EX_expected = "";
+         string m_EX_happened = "";
+
+         int m_ts_counter = 0;
+         double m_time = 0.0;
+         double m_sim_time = 0.0;  // VirtualClock time at its end
+         vector<long long> m_perf {};   // perf counters, see Manager::m_perf_names
+         Usage m_usage {};
+
+         map<string, Teststep> m_tstep {};
+
+         string m_skipped = "";    // why it did not run, e.g. a DEPENDS prerequisite failed
+         bool m_budget = false;    // not started, --time-budget was used up
+         string m_module = "";     // --resident: the shared object it came from
+         string m_output = "";     // --capture: what a failed run (-a: any run) printed
+         long long m_mapped = 0;   // bytes of the testData() files of the run
+         set<string> m_data_files {};
+
+         // repeated runs (--repeat, --until-fail)
+         int m_runs = 0;
+         int m_runs_OK = 0;
+         vector<double> m_samples {};
+         map<string, Teststep> m_failed_tstep {};  // steps of the first failed run
+         bool m_last_ok = true;    // the outcome of the last run
+
+         // --retries: a failed run is retried; --quarantine: out of the verdict
+         int m_retried = 0;        // runs that were retries
+         int m_unrecovered = 0;    // rounds it failed in and no retry passed
+         bool m_quarantined = false;
+
+         // --cold: the runs after a cache eviction, next to the (warm) ones above. A cold
+         // run and the warm one after it count as one run, passed if both passed
+         vector<double> m_cold_samples {};
+         double m_cold_time = 0.0;      // median
+         vector<long long> m_cold_perf {};
+         bool m_cold_ok = true;         // the cold run before the warm one
+         map<string, Teststep> m_cold_tstep {};
+
+         // a new exec(), forget the runs of the previous one (--resident)
+         void clear()
+         {
+            m_runs = 0;
+            m_runs_OK = 0;
+            m_samples.clear();
+            m_cold_samples.clear();
+            m_cold_perf.clear();
+            m_cold_ok = true;
+            m_cold_tstep.clear();
+            m_failed_tstep.clear();
+            m_last_ok = true;
+            m_retried = 0;
+            m_unrecovered = 0;
+            m_skipped = "";
+            m_budget = false;
+            m_output = "";
+         }
+
+         // a new run, forget the steps of the previous one (and that it was skipped)
+         void start()
+         {
+            m_skipped = "";
+            m_budget = false;
+            m_tstep.clear();
+            m_mapped = 0;
+            m_data_files.clear();
+            m_ts_counter = 0;
+            m_is_EX_expected = false;
+            m_is_EX_happened = false;
+            m_EX_expected = "";
+            m_EX_happened = "";
+         }
+
+         // end of a run; returns true if all steps passed
+         bool stop( bool cold = false )
+         {
+            bool ok = true;
+            for( auto & ts : m_tstep )
+            {
+               if( !ts.second.m_OK )
+               {
+                  ok = false;
+                  break;
+               }
+            }
+
+            if( cold )
+            {
+               m_cold_samples.push_back(m_time);
+               m_cold_perf = m_perf;
+               m_cold_ok = ok;
+               if( !ok )
+               {
+                  m_cold_tstep = m_tstep;
+               }
+               return ok;
+            }
+
+            m_runs++;
+            m_samples.push_back(m_time);
+            m_last_ok = ok && m_cold_ok;
+
+            if( m_last_ok )
+            {
+               m_runs_OK++;
+            } else if( m_runs - m_runs_OK == 1 ) {
+               m_failed_tstep = m_cold_ok ? m_tstep : m_cold_tstep;
+            }
+
+            return ok;
+         }
+
+         // after the last run: a failed run is reported rather than a passed one,
+         // the time is the median of all runs
+         void finish()
+         {
+            if( m_runs_OK < m_runs )
+            {
+               m_tstep = m_failed_tstep;
+            }
+
+            if( m_samples.size() > 1 )
+            {
+               m_time = stats().m_median;
+            }
+            m_cold_time = Stats::of(m_cold_samples).m_median;
+         }
+
+         bool flaky() const
+         {
+            return m_runs_OK > 0 && m_runs_OK < m_runs;
+         }
+
+         // every failure was followed by a retry that passed: FLAKY, not failed
+         bool recovered() const
+         {
+            return flaky() && m_retried > 0 && m_unrecovered == 0;
+         }
+
+         // failed, but that does not count
+         bool excused() const
+         {
+            return m_ts_FAIL > 0 && (recovered() || m_quarantined);
+         }
+
+         double passRate() const
+         {
+            return m_runs > 0 ? m_runs_OK * 100.0 / m_runs : 0.0;
+         }
+
+         Stats stats() const
+         {
+            return Stats::of(m_samples);
+         }
+
+         string dump()
+         {
+            ostringstream oss;
+            oss << "\t\tTestcase.m_name     : " << m_name << "\n"
+                << "\t\tTestcase.m_tpath    : " << m_tpath << "\n"
+                << "\t\tTestcase.m_disabled : " <<  m_disabled << "\n"
+                << "\t\tTestcase.m_ts_OK    : " << m_ts_OK << "\n"
+                << "\t\tTestcase.m_ts_FAIL  : " << m_ts_FAIL << "\n"
+                << "\t\tTestcase.m_is_EX_expected : " << boolalpha << m_is_EX_expected << "\n"
+                << "\t\tTestcase.m_is_EX_happened : " << boolalpha << m_is_EX_happened << "\n"
+                << "\t\tTestcase.m_EX_expected: " << m_EX_expected << "\n"
+                << "\t\tTestcase.m_EX_happened: " << m_EX_happened << "\n"
+                << "\t\tTestcase.m_time     : " << m_time << "\n";
+            for( auto c : m_perf )
+            {
+               oss << "\t\tTestcase.m_perf[]  : " << c << "\n";
+            }
+            oss << m_usage.dump()
+                << "\t\tTestcase.m_runs     : " << m_runs << "\n"
+                << "\t\tTestcase.m_runs_OK  : " << m_runs_OK << "\n"
+                << "\t\tTestcase.m_ts_counter  : " << m_ts_counter << "\n"
+                << "\t\tTestcase.m_tstep[] =\n";
+            int c = 0;
+            for( auto & i : m_tstep )
+            {
+               oss << "\t\t\t[" << c++ << "]: " << i.first << "\n"
+                   << i.second.dump();
+            }
+
+            return oss.str();
+         };
+   };
+
+   struct Suite
+   {
+         string m_name = "";
+         int m_tc_OK = 0;
+         int m_tc_FAIL = 0;
+         int m_tc_DISABLED = 0;    // including the skipped ones
+         int m_tc_SKIPPED = 0;
+         int m_tc_BUDGET = 0;      // skipped, --time-budget
+         int m_tc_FLAKY = 0;       // failed, a retry passed; counted as OK
+         int m_tc_QUARANTINED = 0; // failed, on the quarantine list; counted as OK
+
+         map<string, Testcase> m_tcs {};
+
+         string dump()
+         {
+            ostringstream oss;
+            oss << "Suite.m_name       : " << m_name << "\n"
+                << "Suite.m_tc_OK      : " << m_tc_OK << "\n"
+                << "Suite.m_tc_FAIL    : " << m_tc_FAIL << "\n"
+                << "Suite.m_tc_DISABLED: " << m_tc_DISABLED << "\n"
+                << "Suite.m_tcs[] =\n";
+
+            int c = 0;
+            for( auto & i : m_tcs )
+            {
+               oss << "\t[" << c++ << "]: " << i.first << "\n"
+                   << i.second.dump() << "\n";
+            }
+
+            return oss.str();
+         }
+   };
+
+   // DEPENDS
+   struct Dependency
+   {
+         string m_tpath;          // testcase or path
+         string m_prerequisite;   // testcase or path
+         string m_module;         // --resident: the shared object it came from
+   };
+
+   // what earlier runs know about a testcase (--history), for --time-budget
+   struct History
+   {
+         long long m_runs = 0;
+         long long m_fails = 0;
+         double m_time = 0.0;        // expected, moving average of the runs
+         long long m_last_run = 0;   // time(), end of the last exec() that ran it
+         bool m_last_ok = true;
+   };
+
+   class Manager
+   {
+      public:
+         void subscribe( const UT::Probe & sig );
+         void subscribe( UT::FixtureBase & fixture );
+         void unsubscribe( UT::FixtureBase & fixture );
+         void depends( const string & tpath, const string & prerequisite );
+         void crashes( const string & tpath );
+         const UT::DataFile & testData( const string & name, int flags );
+         string dataPath( const string & name );
+         void info( const string & msg );
+         void setFilter(const std::string & filter);
+         void setTitle(const std::string & title);
+         void init_phase_1();
+         string dump();
+         void exec();
+         void fuzz();
+         int resident();
+         void pin( int j );
+         void loadHistory();
+         void saveHistory();
+
+         Testcase & findTC( const UT::Probe & probe );
+
+         void setOK( const UT::Probe & sub);
+         void setFAIL(const UT::Probe & sub);
+         void setExpect(const UT::Probe & sub);
+         void printSummary();
+         void genHTML();
+         void genXML();
+         void genPDF();
+         void genStatistics();
+
+         bool m_PDF = true;
+         bool m_debug = false;
+         bool m_ts_all = false;
+         bool m_perf = false;
+         int m_repeat = 1;
+         bool m_until_fail = false;
+         int m_retries = 0;             // --retries: a failed testcase runs again up to n times
+         vector<string> m_quarantine {};   // --quarantine: testcases (or paths) out of the verdict
+         int m_jobs = 1;
+         bool m_signals = false;        // --catch-signals
+         double m_async_timeout = 10.0; // seconds per ASYNC_TEST
+         bool m_capture = false;        // --capture
+         vector<int> m_cpus {};         // --cpus: thread j runs on m_cpus[j % size]
+         bool m_cold = false;           // --cold: a cold and a warm run per testcase
+         string m_data_root = "";       // --data: root of testData()
+         bool m_update_snapshots = false;  // --update-snapshots
+         bool m_fuzz = false;
+         long long m_fuzz_runs = 0;     // 0: until m_fuzz_time is over
+         double m_fuzz_time = 10.0;     // seconds per FUZZ_TEST
+         string m_corpus = "corpus";
+         vector<string> m_compare {};   // two results.xml
+         vector<string> m_bench {};     // --bench-compare: base and candidate results.xml
+         double m_alpha = 0.05;         // significance level of --bench-compare
+         double m_threshold = 0.02;     // smaller changes are not reported
+         double m_budget = 0.0;         // --time-budget: seconds to start testcases in, 0: no limit
+         string m_history_file = "tmp/history.txt";   // --history
+         vector<UT::FixtureBase *> m_fixtures {};
+         vector<Dependency> m_depends {};
+         map<string, string> m_crashes {};   // CRASHES: testcase or path -> module
+         vector<string> m_modules {};   // --resident
+         bool m_resident = false;
+         const double m_created = monotonic();   // the first TEST_CASE registers
+
+      private:
+         void genGtime(const std::string::size_type pos, std::string & line);
+         void genSummary(const std::string::size_type pos, std::string & line);
+         void genSummary2(const std::string::size_type pos, std::string & line);
+         void genSumSuites(const std::string::size_type pos, std::string & line);
+         void genSuites(const std::string::size_type pos, std::string & line);
+         void genTestResults(const std::string::size_type pos, std::string & line);
+         void genFixtures(const std::string::size_type pos, std::string & line);
+         void genSlowest(const std::string::size_type pos, std::string & line);
+
+         void addTestStep(const UT::Probe & sub, bool okay);
+         void tc_disabled(const UT::Probe & probe);
+         void fixturesInit(const vector<UT::Probe *> & probes);
+         void fixturesDone(const UT::Probe & probe);
+         int runAll(const vector<UT::Probe *> & probes);
+         int retry(const vector<UT::Probe *> & probes, int failed);
+         int runGraph(const vector<UT::Probe *> & probes);
+         int runAsync(const vector<UT::Probe *> & probes, vector<bool> * ok = nullptr);
+         bool load(const string & module);
+         void unload(const string & module);
+         void report(const string & module);
+         bool completeAsync(UT::Async & as);
+         void exceptionStep(Testcase & tc, const string & what, const string & backtrace);
+         void keepOutput(Testcase & tc, bool ok, const Output & out, bool cold = false);
+         void skip(const UT::Probe & probe, const string & reason);
+         bool run(UT::Probe & probe);
+         void prioritize(vector<UT::Probe *> & probes);
+         bool overBudget(const UT::Probe & probe);
+         bool crashing(const UT::Probe & probe);
+         bool runOnce(UT::Probe & probe, bool cold);
+         void replay(UT::Probe & probe, Testcase & tc);
+         void fuzz(UT::Probe & probe);
+         string fuzzOne(UT::Probe & probe, const vector<unsigned char> & in);
+         string corpusDir(const UT::Probe & probe);
+         PerfCounters & counters();
+         void startClock(timespec & t, Usage & u);
+         void stopClock(timespec & t, const Usage & u, Testcase & tc);
+
+         string isWarn( int i );
+         string isWarn( bool b );
+         string isError( int i );
+         string isError( bool b );
+         string sumLine( const string & lab, // label
+                         int a,     // total
+                         int b,     // exec'd
+                         int c,     // OK
+                         float d,   // OK %
+                         int e,     // FAIL
+                         float f,   // FAIL %
+                         int g,     // DISABLED
+                         float h    // DISABLED %
+                         );
+      private:
+         myLambdaMap<UT::Probe>::type m_fmap {};
+
+         std::string m_filter = "";
+         std::string m_title = "";
+
+         vector<string> m_perf_names {};
+
+         int m_round = 0;
+         Host m_host {};     // at the start of exec()
+
+         map<string, History> m_history {};   // tpath -> what the earlier runs saw
+         double m_deadline = 0.0;   // --time-budget: no testcase starts that would end later
+         double m_unknown = 0.0;    // expected time of a testcase without history
+
+         // testData(): mapped until the end
+         map<string, unique_ptr<UT::DataFile>> m_data {};
+         mutex m_data_mutex {};
+         mutex m_mutex {};   // console output and anything shared between workers
+
+         // --resident
+         map<string, void *> m_handles {};   // module -> dlopen() handle
+         string m_loading = "";              // the module being loaded
+         string m_only_module = "";          // exec() runs its testcases only
+
+         int m_su_OK = 0;
+         int m_su_FAIL = 0;
+
+         map<string, Suite> m_suites {};
+   };
+
+   typedef Singleton<Manager> S_Manager;
+
+   string Manager::dump()
+   {
+      ostringstream oss;
+      oss << "m_filter : " << m_filter << "\n"
+          << "m_title  : " << m_title << "\n"
+          << "m_su_OK  : " << m_su_OK << "\n"
+          << "m_su_FAIL: " << m_su_FAIL << "\n";
+
+      oss << " === m_fmap ======================\n";
+
+      int c = 0;
+      for( auto & i : m_fmap )
+      {
+         oss << "[" << c++ << "] <" << i.first << "> -> Probe\n"
+             << i.second.dump() << "\n\n";
+      }
+
+      oss << " === m_suites ====================\n";
+
+      int s = 0;
+      for( auto & i : m_suites )
+      {
+         oss << "[" << s++ << "] " << i.first << "\n";
+         oss << i.second.dump() << "\n\n";
+      }
+
+      return oss.str();
+   }
+
+   // ===============================================================================
+   // Probe code
+
+   void checkForDisable(const string & hierName, bool & disabled, string & newName)
+   {
+      const string Disable = "/DISABLE";
+
+      auto pos = hierName.find(Disable);
+
+      if( pos == string::npos )
+      {
+         disabled = false;
+         newName = hierName;
+         return;
+      }
+
+      if( pos == hierName.size() - Disable.size() )
+      {
+         disabled = true;
+         newName = hierName.substr(0, pos);
+      } else {
+         cerr << "WARNING: " << Disable << " NOT at end of <" << hierName
+              << ">, so NOT disabled!" << endl;
+         disabled = false;
+         newName = hierName;
+      }
+   }
+
+   void convertNames(const string & hierName,
+                     string & suite,
+                     string & name,
+                     bool & disabled)
+   {
+      string newName;
+      checkForDisable(hierName, disabled, newName);
+
+      auto pos = newName.find("/");
+      if( pos == string::npos )
+      {
+         suite = "default";
+         name = newName;
+         return;
+      }
+
+      if( pos == 0 )
+      {
+         pos = newName.find("/",1);
+
+         // if there's no '/' in the name, then assume suite is 'default'
+         if( pos == string::npos)
+         {
+            suite = "default";
+            name = newName.substr(1);
+            return;
+         } else {
+            suite = newName.substr(1,pos-1);
+            name = newName.substr(pos+1);
+            return;
+         }
+      } else {
+         suite = newName.substr(0,pos);
+         name = newName.substr(pos+1);
+         return;
+      }
+   }
+
+// ===============================================================================
+// Manager code
+
+   void Manager::depends( const string & tpath, const string & prerequisite )
+   {
+      m_depends.push_back(Dependency{tpath, prerequisite, m_loading});
+   }
+
+   void Manager::crashes( const string & tpath )
+   {
+      m_crashes[tpath] = m_loading;
+   }
+
+   // an INFO line on the terminal, also from a worker
+   void Manager::info( const string & msg )
+   {
+      lock_guard<mutex> lock(m_mutex);
+      console() << "INFO: " << msg << endl;
+   }
+
+   // name below the data root (--data, $UT_DATA, "data") unless it is absolute
+   string Manager::dataPath( const string & name )
+   {
+      string root = m_data_root;
+      if( root.empty() )
+      {
+         const char * env = getenv("UT_DATA");
+         root = env != nullptr && *env != 0 ? env : "data";
+      }
+      return name.size() > 0 && name[0] == '/' ? name : root + "/" + name;
+   }
+
+   // the mapping of a test data file, made by the first testcase that asks for it
+   const UT::DataFile & Manager::testData( const string & name, int flags )
+   {
+      const string path = dataPath(name);
+
+      unique_lock<mutex> lock(m_data_mutex);
+
+      auto & file = m_data[path];
+      if( !file )
+      {
+         timespec t1, t2;
+         clock_gettime(CLOCK_MONOTONIC, &t1);
+
+         const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+         struct stat st;
+         if( fd < 0 || fstat(fd, &st) != 0 )
+         {
+            const string err = strerror(errno);
+            if( fd >= 0 )
+            {
+               close(fd);
+            }
+            m_data.erase(path);
+            throw runtime_error("testData: can't open <" + path + ">: " + err);
+         }
+
+         void * p = nullptr;
+         if( st.st_size > 0 )
+         {
+            p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED | (flags & UT::DataFile::Populate ? MAP_POPULATE : 0), fd, 0);
+         }
+         const string err = strerror(errno);
+         close(fd);
+         if( p == MAP_FAILED )
+         {
+            m_data.erase(path);
+            throw runtime_error("testData: can't map <" + path + ">: " + err);
+         }
+         if( p != nullptr && (flags & UT::DataFile::HugePages) )
+         {
+            madvise(p, st.st_size, MADV_HUGEPAGE);
+         }
+
+         file.reset(new UT::DataFile{ path, static_cast<const unsigned char *>(p), static_cast<size_t>(st.st_size) });
+
+         // like building a fixture, not the testcase's time
+         clock_gettime(CLOCK_MONOTONIC, &t2);
+         t_setup_time += seconds(t1, t2);
+         s_tracer.span("map " + name, "setup", seconds(t1), seconds(t2));
+      }
+      lock.unlock();
+
+      // bytes mapped per testcase, each file once per run
+      if( t_probe != nullptr )
+      {
+         Testcase & tc = findTC(*t_probe);
+         if( tc.m_data_files.insert(path).second )
+         {
+            tc.m_mapped += file->m_size;
+         }
+      }
+      return *file;
+   }
+
+   void Manager::subscribe( UT::FixtureBase & fixture )
+   {
+      m_fixtures.push_back(&fixture);
+   }
+
+   void Manager::unsubscribe( UT::FixtureBase & fixture )
+   {
+      m_fixtures.erase(remove(m_fixtures.begin(), m_fixtures.end(), &fixture), m_fixtures.end());
+   }
+
+   // the selected testcases a fixture has to wait for
+   void Manager::fixturesInit( const vector<UT::Probe *> & probes )
+   {
+      for( auto f : m_fixtures )
+      {
+         int n = 0;
+         for( auto p : probes )
+         {
+            n += inScope(f->m_scope, p->m_tpath);
+         }
+         f->m_left = n;
+         f->m_users = n;
+      }
+   }
+
+   // the last testcase of a fixture in the last round tears it down
+   void Manager::fixturesDone( const UT::Probe & probe )
+   {
+      // --resident keeps them warm for the next run
+      if( m_round != m_repeat || m_resident )
+      {
+         return;
+      }
+
+      for( auto f : m_fixtures )
+      {
+         if( inScope(f->m_scope, probe.m_tpath) && --f->m_left == 0 )
+         {
+            f->release();
+         }
+      }
+   }
+
+   void Manager::subscribe( const UT::Probe & probe )
+   {
+      m_fmap.insert(make_pair(probe.m_tpath, probe));
+
+      auto p = m_suites.find(probe.m_suite);
+      if( p == m_suites.end() )
+      {
+         Suite suite;
+         suite.m_name = probe.m_suite;
+         // suite.m_tc_DISABLED = probe.m_disabled; // not yet
+         p = m_suites.insert( make_pair(probe.m_suite, suite) ).first;
+      }
+
+      Testcase tc;
+      tc.m_name = probe.m_tname;
+      tc.m_disabled = probe.m_disabled;
+      tc.m_tpath = probe.m_tpath;
+      if( probe.m_group.size() > 0 )
+      {
+         string suite;
+         bool disabled;
+         convertNames(probe.m_group, suite, tc.m_group, disabled);
+      }
+
+      auto t = p->second.m_tcs.find( probe.m_tname );
+      if( t != p->second.m_tcs.end() )
+      {
+         cerr << "ERROR: two testcases have the same name!\n"
+              << "1st: " << p->second.m_name << "/" << t->second.m_name<< " in ";
+         auto ftc = m_fmap.find( tc.m_tpath );
+         if( ftc == m_fmap.end() )
+         {
+            throw logic_error("think I have already a duplicate tc, but can't find it!");
+         }
+
+         cerr << ftc->second.m_fname << ":" << ftc->second.m_line << "\n"
+              << "2nd: " << probe.m_tpath << " in " << probe.m_fname << ":"
+              << probe.m_line << endl;
+
+         // no exception through dlopen(), the 2nd one is left out
+         if( m_loading.size() > 0 )
+         {
+            return;
+         }
+         throw runtime_error("duplicate Testcase names !");
+      }
+
+      tc.m_module = m_loading;
+      p->second.m_tcs.insert( make_pair( tc.m_name, tc ) );
+   }
+
+   void Manager::setTitle(const string & title)
+   {
+      // a reloaded module sets it again
+      if( m_title == title )
+      {
+         return;
+      }
+
+      if( m_title.size() > 0 )
+      {
+         cerr << "Title was already set to <" << m_title << ">\n"
+              << " ignoring <" << title << ">" << endl;
+         return;
+      }
+
+      m_title = title;
+   }
+
+   void Manager::setFilter(const string & filter)
+   {
+      m_filter = filter;
+   }
+
+
+   // ===  Manager end  =======================
+
+   void step_failed_isTrue(UT::Probe & probe,
+                           const string & exprStr)
+   {
+      probe.m_msg = "assert violation";
+
+      ostringstream oss;
+      oss << "[ " << exprStr << " ]";
+      probe.m_expect = oss.str() ;
+
+      probe.m_expect += " => true";
+      probe.m_actual = "   => false";
+
+      S_Manager::getInstance().setFAIL(probe);
+   }
+
+   void Manager::setOK(const UT::Probe & probe)
+   {
+      addTestStep(probe, true );
+   }
+
+   void Manager::setFAIL(const UT::Probe & probe)
+   {
+      addTestStep(probe, false );
+   }
+
+   Testcase & Manager::findTC( const UT::Probe & probe )
+   {
+      auto p = m_suites.find(probe.m_suite);
+      if( p == m_suites.end() )
+      {
+         throw runtime_error("Suite not found!");
+      }
+
+      auto q = p->second.m_tcs.find(probe.m_tname);
+      if( q == p->second.m_tcs.end() )
+      {
+         throw runtime_error("Testcase not found!");
+      }
+
+      return q->second;
+   }
+
+   void Manager::addTestStep( const UT::Probe & probe, bool okay)
+   {
+      // fuzzing: no steps, just the first failure
+      if( t_fuzz != nullptr )
+      {
+         t_fuzz->m_steps++;
+         if( t_fuzz->m_sig.empty() && !(okay && probe.m_EX_expected == probe.m_EX_happened) )
+         {
+            ostringstream oss;
+            oss << "TS-" << setfill('0') << setw(3) << t_fuzz->m_steps << " failed";
+            if( probe.m_EX_happened.size() > 0 )
+            {
+               oss << " with exception " << probe.m_EX_happened;
+            }
+            t_fuzz->m_sig = oss.str();
+         }
+         return;
+      }
+
+      // the time of the bookkeeping (and printing) goes to nobody
+      const StepClock & clock = StepClock::get();
+      const uint64_t now = clock.now();
+      struct Mark
+      {
+            ~Mark() { t_step_mark = StepClock::get().now(); }
+      } mark;
+
+      Teststep ts;
+      ts.m_time = (now - t_step_mark) * clock.m_seconds;
+      ts.m_step = probe.m_step != nullptr ? probe.m_step : "";
+      ts.m_OK = okay;
+      ts.m_desc = probe.m_desc;
+      ts.m_expect = probe.m_expect;
+      ts.m_actual = probe.m_actual;
+      ts.m_EX_expected = probe.m_EX_expected;
+      ts.m_EX_happened = probe.m_EX_happened;
+      ts.m_what = probe.m_what;
+      ts.m_msg = probe.m_msg;
+
+      if( probe.m_EX_expected != probe.m_EX_happened )
+      {
+         ts.m_OK = false;
+         if( probe.m_EX_expected.size() == 0 )
+         {
+            ts.m_msg = "unexpected exception occured!";
+         } else {
+            ts.m_msg = "exceptions do NOT match";
+         }
+
+         if( probe.m_EX_happened == "(UNKNOWN)" )
+         {
+            ts.m_msg += " (UNKNOWN) means it was not derived from std::exception.";
+         }
+      }
+
+      auto & p = findTC( probe );
+
+      ts.m_counter = ++p.m_ts_counter;
+
+      ostringstream oss;
+      oss << "TS-" << setfill('0') << setw(3) << ts.m_counter;
+      string tsName = oss.str();
+
+      if( s_tracer.m_on )
+      {
+         const double end = monotonic();
+         s_tracer.span(tsName, "step", end - ts.m_time, end,
+                       "\"expr\":\"" + jsonEscape(ts.m_step) + "\",\"ok\":" + (ts.m_OK ? "true" : "false"));
+      }
+
+      p.m_tstep.insert(make_pair( tsName, ts));
+
+      // repeated rounds and TEST_PARAM rows only report what went wrong
+      if( (m_round > 1 || p.m_group.size() > 0) && ts.m_OK )
+      {
+         return;
+      }
+
+      lock_guard<mutex> lock(m_mutex);
+
+      if( ts.m_OK )
+      {
+         console() << "passed: ";
+      } else {
+         console() << "FAILED: ";
+      }
+
+      console() << "<" << p.m_name << "> - " << tsName << endl;
+   }
+
+   void Manager::setExpect(const UT::Probe & probe)
+   {
+      auto & p = findTC( probe );
+
+      p.m_is_EX_expected = true;
+      p.m_EX_expected = probe.m_EX_expected;
+   }
+
+
+   void Manager::genStatistics()
+   {
+      TraceSpan span("genStatistics");
+
+      int su_OK = 0;
+      int su_FAIL = 0;
+
+      for( auto & su : m_suites )
+      {
+         int tc_OK = 0;
+         int tc_FAIL = 0;
+         int tc_DISABLED = 0;
+         int tc_SKIPPED = 0;
+         int tc_BUDGET = 0;
+         int tc_FLAKY = 0;
+         int tc_QUARANTINED = 0;
+
+         for( auto & tc : su.second.m_tcs )
+         {
+            int ts_OK = 0;
+            int ts_FAIL = 0;
+            for( auto & ts : tc.second.m_tstep )
+            {
+               if( ts.second.m_OK )
+               {
+                  ts_OK++;
+               } else {
+                  ts_FAIL++;
+               }
+            }
+
+            tc.second.m_ts_OK = ts_OK;
+            tc.second.m_ts_FAIL = ts_FAIL;
+
+            if( tc.second.m_ts_OK > 0 && tc.second.m_disabled )
+            {
+               throw logic_error("Testcase skipped, but teststeps exec'd OK ?!");
+            }
+
+            if( tc.second.m_disabled )
+            {
+               tc_DISABLED++;
+            } else if( tc.second.m_runs == 0 && tc.second.m_skipped.size() > 0 ) {
+               tc_DISABLED++;
+               (tc.second.m_budget ? tc_BUDGET : tc_SKIPPED)++;
+            } else if (tc.second.m_ts_FAIL == 0)
+            {
+               tc_OK++;
+            } else if( tc.second.m_quarantined ) {
+               tc_OK++;
+               tc_QUARANTINED++;
+            } else if( tc.second.recovered() ) {
+               tc_OK++;
+               tc_FLAKY++;
+            } else {
+               tc_FAIL++;
+            }
+         }
+
+         su.second.m_tc_OK = tc_OK;
+         su.second.m_tc_FAIL = tc_FAIL;
+         su.second.m_tc_DISABLED = tc_DISABLED;
+         su.second.m_tc_SKIPPED = tc_SKIPPED;
+         su.second.m_tc_BUDGET = tc_BUDGET;
+         su.second.m_tc_FLAKY = tc_FLAKY;
+         su.second.m_tc_QUARANTINED = tc_QUARANTINED;
+
+         if( tc_FAIL > 0 )
+         {
+            su_FAIL++;
+         } else {
+            su_OK++;
+         }
+      }
+
+      m_su_OK = su_OK;
+      m_su_FAIL = su_FAIL;
+   }
+
+
+   void Manager::printSummary()
+   {
+      TraceSpan span("printSummary");
+
+      cout << "\nSUMMARY: ==========================\n";
+      cout << "  test suites:\n";
+
+      if( m_suites.size() < 1 )
+      {
+         cout << "BAD: NO suites registered..." << endl;
+         return;
+      }
+
+      cout << "    exec'd  : \t" << m_suites.size() << endl;
+      cout << "     OK     : \t" << m_su_OK << "\t" << m_su_OK * 100 / m_suites.size() << "%" << endl;
+      cout << "     FAILED : \t" << m_su_FAIL << "\t" << m_su_FAIL * 100 / m_suites.size() << "%" << endl;
+      cout << "\n  test cases:\n";
+
+      int tc_OK = 0;
+      int tc_FAIL = 0;
+      int tc_DISABLE = 0;
+      int tc_BUDGET = 0;
+
+      for( auto & i : m_suites )
+      {
+         tc_OK += i.second.m_tc_OK;
+         tc_FAIL += i.second.m_tc_FAIL;
+         tc_DISABLE += i.second.m_tc_DISABLED;
+         tc_BUDGET += i.second.m_tc_BUDGET;
+      }
+
+      int tc_exec = tc_OK + tc_FAIL;
+
+      if( tc_exec < 1 )
+      {
+         cout << "BAD: ALL testcases were DISABLED..." << endl;
+         return;
+      }
+
+      if( m_fmap.size() < 1 )
+      {
+         cout << "BAD: NO testcases were registed..." << endl;
+         return;
+      }
+
+      cout << "    exec'd  : \t" << tc_exec << "\t" << tc_exec * 100 / (tc_exec + tc_DISABLE) << "%" << endl;
+      cout << "    disabled: \t" << tc_DISABLE << "\t" << tc_DISABLE * 100 / m_fmap.size() << "%" << endl;
+
+      for( auto & i : m_suites )
+      {
+         for( auto & tc : i.second.m_tcs )
+         {
+            if( tc.second.m_runs == 0 && tc.second.m_skipped.size() > 0 && !tc.second.m_budget )
+            {
+               cout << "     SKIPPED: \t" << tc.second.m_tpath << " (" << tc.second.m_skipped << ")" << endl;
+            }
+         }
+      }
+      if( tc_BUDGET > 0 )
+      {
+         cout << "     BUDGET : \t" << tc_BUDGET << "\t(not started, --time-budget; see the report)" << endl;
+      }
+
+      cout << "     OK     : \t" << tc_OK << "\t" << tc_OK * 100 / tc_exec << "%" << endl;
+      cout << "     FAILED : \t" << tc_FAIL << "\t" << tc_FAIL * 100 / tc_exec << "%" << endl;
+
+      for( auto & i : m_suites )
+      {
+         for( auto & tc : i.second.m_tcs )
+         {
+            if( tc.second.flaky() )
+            {
+               cout << "     FLAKY  : \t" << tc.second.m_tpath << " (" << setprecision(3)
+                    << tc.second.passRate() << "% of " << tc.second.m_runs << " runs passed"
+                    << (tc.second.recovered() && !tc.second.m_quarantined ? ", a retry passed: counted as OK)" : ")") << endl;
+            }
+            if( tc.second.m_quarantined && tc.second.m_runs > 0 )
+            {
+               cout << "     QUARANTINED: \t" << tc.second.m_tpath
+                    << (tc.second.m_ts_FAIL == 0 ? " (passed)" : " (failed, counted as OK)") << endl;
+            }
+         }
+      }
+
+      cout << "\n  test steps:\n";
+
+      int ts_OK = 0;
+      int ts_FAIL = 0;
+
+      for( auto & i : m_suites )
+      {
+         for( auto & tc : i.second.m_tcs )
+         {
+            if( !tc.second.m_disabled )
+            {
+               ts_OK += tc.second.m_ts_OK;
+               ts_FAIL += tc.second.m_ts_FAIL;
+            }
+         }
+      }
+
+      int ts_exec = ts_OK + ts_FAIL;
+
+      if( ts_exec < 1 )
+      {
+         cout << "BAD: NO teststeps were exec'd..." << endl;
+         return;
+      }
+
+      cout << "    exec'd  : \t" << ts_exec << endl;
+      cout << "     OK     : \t" << ts_OK << "\t" <<  ts_OK * 100 / ts_exec  << "%" << endl;
+      cout << "     FAILED : \t" << ts_FAIL << "\t" <<  ts_FAIL * 100 / ts_exec << "%" << endl;
+      if( tc_FAIL > 0 )
+      {
+         cout << "=====================================\n";
+         cout << "======  B A D  ======================\n";
+         cout << "=====================================";
+      } else {
+         cout << "======  O K  ========================";
+      }
+      cout << endl;
+   }
+
+   const char * const s_html[] = {
+
+      "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Strict//EN\" \"http://www.w3.org/TR/xhtml1/DTD/xhtml1-strict.dtd\">",
+      "<html xmlns=\"http://www.w3.org/1999/xhtml\" xml:lang=\"en\" lang=\"en\">",
+      "<head>",
+      "  <meta http-equiv=\"content-type\" content=\"text/html; charset=utf-8\" />",
+      "  <meta name=\"generator\" content=\"CPP11UT - http://redmine.x64it.com/projects/cpp11ut1\" />",
+      "  <title>$TITLE$ - UT Results</title>",
+      "",
+      "  <style type=\"text/css\" media=\"screen\">",
+      "    <!--",
+      "    hr  {",
+      "      width: 99%;",
+      "      border-width: 0px;",
+      "      height: 3px;",
+      "      color: #ccbbcc;",
+      "      background-color: #cc33cc;",
+      "      padding: 0px;",
+      "    }",
+      "",
+      "    table {",
+      "      width:100%;",
+      "      border-collapse:separate;",
+      "      border-spacing: 2px;",
+      "      border:0px;",
+      "    }",
+      "    tr {",
+      "      margin:0px;",
+      "      padding:0px;",
+      "    }",
+      "    td {",
+      "      margin:0px;",
+      "      padding:1px;",
+      "    }",
+      "    .table_summary {",
+      "      background-color: #b0b0b0;",
+      "    }",
+      "    .table_suites {",
+      "      background-color: #b0b0b0;",
+      "    }",
+      "    .table_suite {",
+      "      background-color: #b0b0b0;",
+      "    }",
+      "    .table_result {",
+      "      background-color: #b0b0b0;",
+      "      margin: 0px 0px 1em 0px;",
+      "    }",
+      "    .tablecell_title {",
+      "      background-color: #a5cef7;",
+      "      font-weight: bold;",
+      "      text-align: center;",
+      "    }",
+      "",
+      "    .tablecell_success {",
+      "      background-color: #efefe7;",
+      "      text-align: center;",
+      "    }",
+      "",
+      "    .tablecell_left {",
+      "      background-color: #efefe7;",
+      "      text-align: left;",
+      "    }",
+      "",
+      "    .tablecell_lefterror {",
+      "      color: #ff0808;",
+      "      background-color: #efbfe7;",
+      "      font-weight: bold;",
+      "      text-align: left;",
+      "    }",
+      "",
+      "    .tablecell_warn {",
+      "      background-color: #ffff80;",
+      "      text-align: center;",
+      "    }",
+      "",
+      "    .tablecell_error {",
+      "      color: #ff0808;",
+      "      background-color: #efbfe7;",
+      "      font-weight: bold;",
+      "      text-align: center;",
+      "    }",
+      "    p.spaced {",
+      "      margin: 0px;",
+      "      padding: 3px 0px 3px 0px;",
+      "    }",
+      "    p.unspaced {",
+      "      margin: 0px;",
+      "      padding: 0px 0px 2em 0px;",
+      "    }",
+      "    -->",
+      "  </style>",
+      "</head>",
+      "",
+      "<body>",
+      "",
+      "<table>",
+      " <tr>",
+      "  <td>",
+      "   <h1><a name=\"top\"></a>$TITLE$ - Unit Tests Results</h1>",
+      "  </td>",
+      "  <td>",
+      "   <div style=\"text-align:right\">",
+      "    <a href=\"http://redmine.x64it.com/projects/cpp11ut1\">CPP11UT</a> v0.2 &copy; 2013",
+      "   </div>",
+      "   <div style=\"text-align:right\">",
+      "    by Andreas Boerner",
+      "   </div>",
+      "  </td>",
+      " </tr>",
+      "</table>",
+      "$GTIME$",
+      "<hr />",
+      "",
+      "<h2>Summary</h2>",
 
       "$SUMMARY$",
 
-      "<table style=\"table-layout: fixed;\" summary=\"Summary of test results\" class=\"table_summary\">",
-      " <col width=\"120px\" />",
-      "  <tr>",
-      "    <td style=\"width: 400px;\" class=\"tablecell_title\"></td>",
-      "    <td class=\"tablecell_title\">Total</td>",
-      "    <td class=\"tablecell_title\">Exec'd</td>",
-      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">OK</td>",
-      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">DISABLED</td>",
-      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">FAIL</td>",
-      "  </tr>",
-      "  <tr>",
-      "    <td style=\"\" class=\"tablecell_title\"></td>",
-      "    <td style=\"\" class=\"tablecell_title\"></td>",
-      "    <td style=\"\" class=\"tablecell_title\"></td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
-      "  </tr>",
-      "$SUMMARY-2$",
-      "<hr />",
-      "",
-      "<h2>Test Suites</h2>",
-      "<h3>Summary</h3>",
-      "<table style=\"table-layout: fixed;\" summary=\"Summary of test suites\" class=\"table_summary\">",
-      " <col width=\"200px\" />",
-      "  <tr>",
-      "    <td style=\"text-align: left;\" class=\"tablecell_title\">Suite</td>",
-      "    <td class=\"tablecell_title\">Total</td>",
-      "    <td class=\"tablecell_title\">Exec'd</td>",
-      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">OK</td>",
-      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">DISABLED</td>",
-      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">FAIL</td>",
-      "    <td class=\"tablecell_title\">Time</td>",
-      "  </tr>",
-      "  <tr>",
-      "    <td style=\"\" class=\"tablecell_title\"></td>",
-      "    <td style=\"\" class=\"tablecell_title\">testcases</td>",
-      "    <td style=\"\" class=\"tablecell_title\">testcases</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
-      "    <td style=\"text-align:center;\" class=\"tablecell_title\">s</td>",
-      "  </tr>",
-      "$SUM-SUITES$",
-      "</table>",
-      "$SUITES$",
-      "",
-      "$TESTRESULTS$",
-      "<hr />",
-      "</body>",
-      "</html>"
-   };
+      "<table style=\"table-layout: fixed;\" summary=\"Summary of test results\" class=\"table_summary\">",
+      " <col width=\"120px\" />",
+      "  <tr>",
+      "    <td style=\"width: 400px;\" class=\"tablecell_title\"></td>",
+      "    <td class=\"tablecell_title\">Total</td>",
+      "    <td class=\"tablecell_title\">Exec'd</td>",
+      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">OK</td>",
+      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">DISABLED / SKIPPED</td>",
+      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">FAIL</td>",
+      "  </tr>",
+      "  <tr>",
+      "    <td style=\"\" class=\"tablecell_title\"></td>",
+      "    <td style=\"\" class=\"tablecell_title\"></td>",
+      "    <td style=\"\" class=\"tablecell_title\"></td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
+      "  </tr>",
+      "$SUMMARY-2$",
+      "<hr />",
+      "",
+      "<h2>Test Suites</h2>",
+      "<h3>Summary</h3>",
+      "<table style=\"table-layout: fixed;\" summary=\"Summary of test suites\" class=\"table_summary\">",
+      " <col width=\"200px\" />",
+      "  <tr>",
+      "    <td style=\"text-align: left;\" class=\"tablecell_title\">Suite</td>",
+      "    <td class=\"tablecell_title\">Total</td>",
+      "    <td class=\"tablecell_title\">Exec'd</td>",
+      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">OK</td>",
+      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">DISABLED / SKIPPED</td>",
+      "    <td colspan = \"2\" style=\"text-align:center;\" class=\"tablecell_title\">FAIL</td>",
+      "    <td class=\"tablecell_title\">Time</td>",
+      "  </tr>",
+      "  <tr>",
+      "    <td style=\"\" class=\"tablecell_title\"></td>",
+      "    <td style=\"\" class=\"tablecell_title\">testcases</td>",
+      "    <td style=\"\" class=\"tablecell_title\">testcases</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">#</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">%</td>",
+      "    <td style=\"text-align:center;\" class=\"tablecell_title\">s</td>",
+      "  </tr>",
+      "$SUM-SUITES$",
+      "</table>",
+      "$FIXTURES$",
+      "$SUITES$",
+      "$SLOWEST$",
+      "",
+      "$TESTRESULTS$",
+      "<hr />",
+      "</body>",
+      "</html>"
+   };
+
+   void Manager::genSuites(const std::string::size_type pos, std::string & line)
+   {
+      ostringstream oss;
+      bool disabled = false;
+
+      for( auto & s : m_suites )
+      {
+         oss << "<h3><a name=\"" << s.second.m_name << "\"></a>Suite: " <<  s.second.m_name << "</h3>\n";
+         oss << "<table style=\"table-layout: fixed;\" summary=\"Details for suite " <<  s.second.m_name << "\" class=\"table_suite\">\n";
+         oss << " <col width=\"200px\" />\n";
+         oss << "  <tr>\n";
+         oss << "    <td style=\"text-align: left;\" class=\"tablecell_title\">Test Case Name</td>\n";
+         oss << "    <td style=\"width:40%\" class=\"tablecell_title\">description</td>\n";
+         oss << "    <td class=\"tablecell_title\">exec'd</td>\n";
+         oss << "    <td colspan=\"2\" class=\"tablecell_title\">OK</td>\n";
+         oss << "    <td colspan=\"2\" class=\"tablecell_title\">FAIL</td>\n";
+         oss << "    <td class=\"tablecell_title\">Time</td>\n";
+         oss << "    <td class=\"tablecell_title\">CPU</td>\n";
+         oss << "    <td class=\"tablecell_title\">Faults</td>\n";
+         oss << "    <td class=\"tablecell_title\">Ctx-Sw</td>\n";
+         oss << "    <td class=\"tablecell_title\">Max RSS</td>\n";
+         oss << "    <td class=\"tablecell_title\">I/O</td>\n";
+         if( m_repeat > 1 )
+         {
+            oss << "    <td class=\"tablecell_title\">Runs</td>\n";
+            oss << "    <td class=\"tablecell_title\">p95</td>\n";
+            oss << "    <td class=\"tablecell_title\">Stddev</td>\n";
+         }
+         for( auto & n : m_perf_names )
+         {
+            oss << "    <td class=\"tablecell_title\">" << n << "</td>\n";
+         }
+         oss << "  </tr>\n";
+         oss << "  <tr>\n";
+         oss << "    <td style=\"text-align: left;\" class=\"tablecell_title\"> </td>\n";
+         oss << "    <td style=\"width:40%\" class=\"tablecell_title\"> </td>\n";
+         oss << "    <td class=\"tablecell_title\">test steps</td>\n";
+         oss << "    <td class=\"tablecell_title\">#</td>\n";
+         oss << "    <td class=\"tablecell_title\">%</td>\n";
+         oss << "    <td class=\"tablecell_title\">#</td>\n";
+         oss << "    <td class=\"tablecell_title\">%</td>\n";
+         oss << "    <td class=\"tablecell_title\">s</td>\n";
+         oss << "    <td class=\"tablecell_title\">thread / proc</td>\n";
+         oss << "    <td class=\"tablecell_title\">minor / major</td>\n";
+         oss << "    <td class=\"tablecell_title\">vol / invol</td>\n";
+         oss << "    <td class=\"tablecell_title\"> </td>\n";
+         oss << "    <td class=\"tablecell_title\">read / written</td>\n";
+         if( m_repeat > 1 )
+         {
+            oss << "    <td class=\"tablecell_title\">passed / total</td>\n";
+            oss << "    <td class=\"tablecell_title\">s</td>\n";
+            oss << "    <td class=\"tablecell_title\">s</td>\n";
+         }
+         for( size_t n = 0; n < m_perf_names.size(); ++n )
+         {
+            oss << "    <td class=\"tablecell_title\">#</td>\n";
+         }
+         oss << "  </tr>\n";
+
+         // TEST_PARAM rows: one summary line, then only the rows that did not pass
+         struct Group
+         {
+               int rows = 0;
+               int rows_FAIL = 0;
+               int ts_OK = 0;
+               int ts_FAIL = 0;
+               double time = 0.0;
+               bool shown = false;
+         };
+         map<string, Group> groups;
+
+         for( auto & tc : s.second.m_tcs )
+         {
+            if( tc.second.m_group.size() > 0 && !tc.second.m_disabled )
+            {
+               Group & g = groups[tc.second.m_group];
+               g.rows++;
+               g.rows_FAIL += tc.second.m_ts_FAIL > 0;
+               g.ts_OK += tc.second.m_ts_OK;
+               g.ts_FAIL += tc.second.m_ts_FAIL;
+               g.time += tc.second.m_time;
+            }
+         }
+
+         disabled = false;
+         for( auto & tc : s.second.m_tcs )
+         {
+            auto p = m_fmap.find(tc.second.m_tpath);
+            if( p == m_fmap.end() )
+            {
+               throw runtime_error("can't find tpath in m_fmap !");
+            }
+
+            auto g = groups.find(tc.second.m_group);
+            if( g != groups.end() )
+            {
+               Group & gr = g->second;
+               if( !gr.shown )
+               {
+                  const string cls = isError(gr.rows_FAIL);
+                  const int ts = gr.ts_OK + gr.ts_FAIL;
+
+                  oss << "  <tr>\n";
+                  oss << "    <td style=\"text-align:left;\" class=\"tablecell_" << cls << "\">"
+                      << g->first << "</td>\n";
+                  oss << "    <td style=\"text-align:left;\" class=\"tablecell_" << cls << "\">"
+                      << gr.rows << " rows: " << gr.rows - gr.rows_FAIL << " passed, "
+                      << gr.rows_FAIL << " failed</td>\n";
+                  oss << "    <td class=\"tablecell_" << cls << "\">" << ts << "</td>\n";
+                  oss << "    <td class=\"tablecell_" << cls << "\">" << gr.ts_OK << "</td>\n";
+                  oss << "    <td class=\"tablecell_" << cls << "\">" << setprecision(3)
+                      << (ts > 0 ? gr.ts_OK * 100.0 / ts : 0.0) << "</td>\n";
+                  oss << "    <td class=\"tablecell_" << cls << "\">" << gr.ts_FAIL << "</td>\n";
+                  oss << "    <td class=\"tablecell_" << cls << "\">" << setprecision(3)
+                      << (ts > 0 ? gr.ts_FAIL * 100.0 / ts : 0.0) << "</td>\n";
+                  oss << "    <td class=\"tablecell_" << cls << "\">" << printTime(gr.time) << "</td>\n";
+                  oss << "  </tr>\n";
+                  gr.shown = true;
+               }
+
+               if( tc.second.m_ts_FAIL == 0 )
+               {
+                  continue;
+               }
+            }
+
+            if( tc.second.m_disabled )
+            {
+               oss << "  <tr>\n";
+               oss << "    <td style=\"text-align:left;\" class=\"tablecell_warn\">" << tc.second.m_name << "</td>\n";
+               oss << "    <td style=\"text-align:left;\" class=\"tablecell_warn\">" << p->second.m_desc << "</td>\n";
+               oss << "  </tr>\n";
+               disabled = true;
+               continue;
+            }
+
+            if( tc.second.m_runs == 0 && tc.second.m_skipped.size() > 0 )
+            {
+               oss << "  <tr>\n";
+               oss << "    <td style=\"text-align:left;\" class=\"tablecell_warn\">" << tc.second.m_name
+                   << (tc.second.m_budget ? " <b>BUDGET</b></td>\n" : " <b>SKIPPED</b></td>\n");
+               oss << "    <td style=\"text-align:left;\" class=\"tablecell_warn\">" << p->second.m_desc
+                   << " (" << tc.second.m_skipped << ")</td>\n";
+               oss << "  </tr>\n";
+               continue;
+            }
+
+            // a retry passed (--retries) or quarantined: a warning, not an error
+            const string cls = tc.second.excused() ? "warn" : isError(tc.second.m_ts_FAIL);
+
+            oss << "  <tr>\n";
+            oss << "    <td style=\"text-align:left;\" class=\"tablecell_" << cls << "\">";
+
+            if( tc.second.m_ts_FAIL > 0 )
+            {
+               oss << "<a href=\"#" << s.second.m_name << "_" << tc.second.m_name << "\">";
+            }
+
+            oss << tc.second.m_name;
+
+            if( tc.second.m_ts_FAIL > 0 )
+            {
+               oss << "</a>";
+            }
+
+            if( tc.second.flaky() )
+            {
+               oss << " <b>FLAKY</b> (" << setprecision(3) << tc.second.passRate() << "% passed)";
+            }
+            if( tc.second.m_quarantined )
+            {
+               oss << " <b>QUARANTINED</b>";
+            }
+
+            oss << "</td>\n";
+
+            oss << "    <td style=\"text-align:left;\" class=\"tablecell_" << cls
+                << "\">" << p->second.m_desc << "</td>\n";
+
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << tc.second.m_ts_OK + tc.second.m_ts_FAIL << "</td>\n";
+
+            oss << "    <td class=\"tablecell_" << cls << "\">" << tc.second.m_ts_OK << "</td>\n";
+
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << setprecision(3) << tc.second.m_ts_OK * 100.0 / (tc.second.m_ts_OK + tc.second.m_ts_FAIL) << "</td>\n";
+
+            oss << "    <td class=\"tablecell_" << cls << "\">" << tc.second.m_ts_FAIL << "</td>\n";
+
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << setprecision(3) << tc.second.m_ts_FAIL * 100.0 / (tc.second.m_ts_OK + tc.second.m_ts_FAIL) << "</td>\n";
+
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << printTime( tc.second.m_time );
+            if( tc.second.m_sim_time > 0 )
+            {
+               oss << "<br />(simulated " << printTime( tc.second.m_sim_time ) << ")";
+            }
+            if( tc.second.m_cold_samples.size() > 0 )
+            {
+               oss << "<br />cold " << printTime( tc.second.m_cold_time );
+            }
+            oss << "</td>\n";
+
+            const Usage & u = tc.second.m_usage;
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << printTime( u.m_cpu_time ) << " / " << printTime( u.m_proc_cpu_time ) << "</td>\n";
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << u.m_minflt << " / " << u.m_majflt << "</td>\n";
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << u.m_nvcsw << " / " << u.m_nivcsw << "</td>\n";
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << printBytes( u.m_maxrss * 1024LL ) << "</td>\n";
+            oss << "    <td class=\"tablecell_" << cls << "\">"
+                << printBytes( u.m_rchar ) << " / " << printBytes( u.m_wchar );
+            if( tc.second.m_mapped > 0 )
+            {
+               oss << "<br />mapped " << printBytes( tc.second.m_mapped );
+            }
+            oss << "</td>\n";
+
+            if( m_repeat > 1 )
+            {
+               Stats st = tc.second.stats();
+               oss << "    <td class=\"tablecell_" << cls << "\">"
+                   << tc.second.m_runs_OK << " / " << tc.second.m_runs << "</td>\n";
+               oss << "    <td class=\"tablecell_" << cls << "\">"
+                   << printTime( st.m_p95 ) << "</td>\n";
+               oss << "    <td class=\"tablecell_" << cls << "\">"
+                   << printTime( st.m_stddev ) << "</td>\n";
+            }
+
+            for( size_t n = 0; n < m_perf_names.size(); ++n )
+            {
+               oss << "    <td class=\"tablecell_" << cls << "\">";
+               if( n < tc.second.m_perf.size() && tc.second.m_perf[n] >= 0 )
+               {
+                  oss << printCount( tc.second.m_perf[n] );
+               }
+               if( n < tc.second.m_cold_perf.size() && tc.second.m_cold_perf[n] >= 0 )
+               {
+                  oss << "<br />cold " << printCount( tc.second.m_cold_perf[n] );
+               }
+               oss << "</td>\n";
+            }
+            oss << "  </tr>\n";
+         }
+         oss << "</table>\n";
+
+         if( disabled )
+         {
+            oss << "  <br />\n<table>\n"
+                << "  <tr>\n  <td style=\"text-align:left;\" class=\"tablecell_warn\"> test cases marked yellow were DISABLED !</td>\n</tr>\n</table>\n";
+         }
+         oss << "<p class=\"spaced\"><a href=\"#top\">Back to top</a></p>\n";
+      }
+
+      line.replace(pos, 8, oss.str());
+   }
+
+   void Manager::genSummary(const string::size_type pos, string & line)
+   {
+      string insHtml;
+      insHtml.reserve(2000);
+
+      int tc_OK = 0;
+      int tc_FAIL = 0;
+      int tc_DISABLE = 0;
+      int tc_BUDGET = 0;
+
+      for( auto & i : m_suites )
+      {
+         tc_OK += i.second.m_tc_OK;
+         tc_FAIL += i.second.m_tc_FAIL;
+         tc_DISABLE += i.second.m_tc_DISABLED;
+         tc_BUDGET += i.second.m_tc_BUDGET;
+      }
+
+      // handle OK/FAIL
+      if( tc_FAIL > 0 )
+      {
+         ostringstream oss;
+         double percent = tc_FAIL * 100 / m_fmap.size();
+         oss << "<h3 style=\"color: red; background-color: yellow;\">FAILED testcases: "
+             << tc_FAIL << " (" << setprecision(3) << percent << "%)</h3>";
+
+         insHtml = oss.str();
+
+      } else {
+         ostringstream oss;
+
+         oss << "<h3 style=\"color: green;\">OK testcases: " << tc_OK << " (100%)</h3>";
+         insHtml = oss.str();
+      }
+
+      // handle disabled testcases
+      if( tc_DISABLE > 0 )
+      {
+         ostringstream oss;
+         double percent = tc_DISABLE * 100 / m_fmap.size();
+         oss << "<h3 style=\"color: black; background-color: yellow;\">DISABLED testcases: "
+             << tc_DISABLE << " (" << setprecision(3) << percent << "%)</h3>";
+
+         insHtml += oss.str();
+
+      } else {
+         insHtml += "<h3 style=\"color: green;\">EXEC'd: 100%</h3>";
+      }
+
+      if( tc_BUDGET > 0 )
+      {
+         ostringstream oss;
+         oss << "<h3 style=\"color: black; background-color: yellow;\">not started (--time-budget): "
+             << tc_BUDGET << "</h3>";
+         insHtml += oss.str();
+      }
+
+      line.replace(pos,9, insHtml);
+   }
+
+   string Manager::isWarn( int i )
+   {
+      if( i > 0 ) return "warn";
+      return "success";
+   }
+
+   string Manager::isWarn( bool b )
+   {
+      if( b ) return "warn";
+      return "success";
+   }
+
+   string Manager::isError( int i )
+   {
+      if( i > 0 ) return "error";
+      return "success";
+   }
+
+   string Manager::isError( bool b )
+   {
+      if( b ) return "error";
+      return "success";
+   }
+
+   string Manager::sumLine( const string & lab, // label
+                            int a,     // total
+                            int b,     // exec'd
+                            int c,     // OK
+                            float d,   // OK %
+                            int e,     // FAIL
+                            float f,   // FAIL %
+                            int g,     // DISABLED
+                            float h    // DISABLED %
+                            )
+   {
+      ostringstream oss;
+
+      // first cell (label)
+      oss << "  <tr>\n" << "    <td style=\"text-align: left;\" class=\"tablecell_";
+      if( e > 0 )
+      {
+         oss << "error";
+      }  else if (g > 0)
+      {
+         oss << "warn";
+      } else {
+         oss << "success";
+      }
+
+      oss << "\">" << lab << "</td>\n";
+
+      // 2. cell (total)
+      if( a < 0 )
+      {
+         oss << "    <td class=\"tablecell_success";
+         oss << "\"> " << "</td>\n";
+      } else {
+         oss << "    <td class=\"tablecell_success";
+         oss << "\">" << a << "</td>\n";
+      }
+
+      // 3. cell (exec'd)
+      oss << "    <td class=\"tablecell_" << isWarn( b<a )
+          << "\">" << b << "</td>\n";
+
+      // 4. cell # OK
+      oss << "    <td class=\"tablecell_success"
+          << "\">" << c << "</td>\n";
+
+      // 5. cell % OK
+      oss << "    <td class=\"tablecell_success"
+          << "\">" << setprecision(3) << d << "</td>\n";
+
+      // 6. cell # DISABLED
+      if( g < 0 )
+      {
+         oss << "    <td class=\"tablecell_success"
+             << "\"> " << "</td>\n";
+      } else {
+         oss << "    <td class=\"tablecell_" << isWarn(g)
+             << "\">" << g << "</td>\n";
+      }
+
+      // 7. cell % DISABLED
+      if( g < 0 )
+      {
+         oss << "    <td class=\"tablecell_success"
+             << "\"> " << "</td>\n";
+      } else {
+         oss << "    <td class=\"tablecell_" << isWarn(g)
+             << "\">" << setprecision(3) << h << "</td>\n";
+      }
+
+      // 8. cell # FAIL
+      oss << "    <td class=\"tablecell_" << isError(e)
+          << "\">" << e << "</td>\n";
+
+      // 9. cell % FAIL
+      oss << "    <td class=\"tablecell_" << isError(e)
+          << "\">" << setprecision(3) << f << "</td>\n";
+
+      oss << "  </tr>\n";
+
+      return oss.str();
+   }
+
+   void Manager::genSummary2(const string::size_type pos, string & line)
+   {
+      string insHtml;
+      insHtml.reserve(2000);
+
+      ostringstream oss;
+
+      insHtml += sumLine("Test Suites",       // label in first column
+                         m_suites.size(),     // total number of test suites
+                         m_su_OK + m_su_FAIL, // test suites exec'd
+                         m_su_OK,             // test suites OK
+                         m_su_OK * 100.0 / (m_su_OK + m_su_FAIL), // percent
+                         m_su_FAIL,           // test suites failed
+                         m_su_FAIL * 100.0 / (m_su_OK + m_su_FAIL),
+                         -1,
+                         0.0 );
+
+      {
+         int tc_OK = 0;
+         int tc_FAIL = 0;
+         int tc_DISABLE = 0;
+
+         for( auto & i : m_suites )
+         {
+            tc_OK += i.second.m_tc_OK;
+            tc_FAIL += i.second.m_tc_FAIL;
+            tc_DISABLE += i.second.m_tc_DISABLED;
+         }
+
+         insHtml += sumLine("Test Cases",     // label in first column
+                            m_fmap.size(),    // total number of test cases
+                            tc_OK + tc_FAIL,  // test cases exec'd
+                            tc_OK ,           // test cases OK
+                            tc_OK * 100.0 / (tc_OK + tc_FAIL), // percent
+                            tc_FAIL,          // test cases failed
+                            tc_FAIL * 100.0 / (tc_OK + tc_FAIL),
+                            tc_DISABLE,
+                            tc_DISABLE * 100.0 / m_fmap.size()
+                            );
+      }
+
+      {
+         int ts_OK = 0;
+         int ts_FAIL = 0;
+
+         for( auto & s : m_suites )
+         {
+            for( auto & tc : s.second.m_tcs )
+            {
+               ts_OK += tc.second.m_ts_OK;
+               ts_FAIL += tc.second.m_ts_FAIL;
+            }
+         }
+
+         insHtml += sumLine("Test Steps",  // label in first column
+                            -1,                 // total number of test cases
+                            ts_OK + ts_FAIL,    // test cases exec'd
+                            ts_OK ,             // test cases OK
+                            ts_OK * 100.0 / ( ts_OK + ts_FAIL), // percent
+                            ts_FAIL, // test suites failed
+                            ts_FAIL * 100.0 / (ts_OK + ts_FAIL),
+                            -1,
+                            0.0 );
+      }
+
+      {
+         double t = 0;
+         for( auto & s : m_suites )
+         {
+            for( auto & tc : s.second.m_tcs )
+            {
+               t += tc.second.m_time;
+            }
+         }
+
+         ostringstream oss;
+         oss << "</table>\n" << "<p>Total time elapsed: "
+             << printTime(t) << "</p>\n";
+
+         insHtml += oss.str();
+      }
+
+      line.replace(pos,11, insHtml);
+   }
+
+
+   void Manager::genFixtures(const string::size_type pos, string & line)
+   {
+      ostringstream oss;
+
+      if( m_fixtures.size() > 0 )
+      {
+         oss << "<h3>Fixtures</h3>\n"
+             << "<table style=\"table-layout: fixed;\" summary=\"Fixtures\" class=\"table_summary\">\n"
+             << " <col width=\"200px\" />\n"
+             << "  <tr>\n"
+             << "    <td style=\"text-align: left;\" class=\"tablecell_title\">Fixture</td>\n"
+             << "    <td class=\"tablecell_title\">Scope</td>\n"
+             << "    <td class=\"tablecell_title\">Testcases</td>\n"
+             << "    <td class=\"tablecell_title\">Built for</td>\n"
+             << "    <td class=\"tablecell_title\">Setup</td>\n"
+             << "    <td class=\"tablecell_title\">Teardown</td>\n"
+             << "  </tr>\n";
+
+         for( auto f : m_fixtures )
+         {
+            oss << "  <tr>\n"
+                << "    <td style=\"text-align:left;\" class=\"tablecell_success\">" << f->m_name << "</td>\n"
+                << "    <td class=\"tablecell_success\">" << (f->m_scope.empty() ? "(all)" : f->m_scope) << "</td>\n"
+                << "    <td class=\"tablecell_success\">" << f->m_users << "</td>\n"
+                << "    <td class=\"tablecell_success\">" << (f->m_first.empty() ? "(not used)" : f->m_first) << "</td>\n"
+                << "    <td class=\"tablecell_success\">" << printTime(f->m_setup_time) << "</td>\n"
+                << "    <td class=\"tablecell_success\">" << printTime(f->m_teardown_time) << "</td>\n"
+                << "  </tr>\n";
+         }
+         oss << "</table>\n";
+      }
+
+      line.replace(pos, 10, oss.str());
+   }
+
+   // where the time of the slowest testcases went, step by step
+   void Manager::genSlowest(const string::size_type pos, string & line)
+   {
+      const size_t slowest = 10;
+
+      vector<const Testcase *> tcs;
+      for( auto & s : m_suites )
+      {
+         for( auto & tc : s.second.m_tcs )
+         {
+            if( tc.second.m_runs > 0 && tc.second.m_tstep.size() > 0 )
+            {
+               tcs.push_back(&tc.second);
+            }
+         }
+      }
+      sort(tcs.begin(), tcs.end(), [](const Testcase * a, const Testcase * b) { return a->m_time > b->m_time; });
+      tcs.resize(min(tcs.size(), slowest));
+
+      ostringstream oss;
+      if( tcs.size() > 0 )
+      {
+         oss << "<h3>Slowest Testcases</h3>\n"
+             << "<p class=\"spaced\">time of a step: since the previous step (the first: since the start),"
+             << " clock: " << StepClock::get().name() << "</p>\n";
+      }
+
+      for( auto tc : tcs )
+      {
+         oss << "<table style=\"table-layout: fixed;\" summary=\"Step times of " << xmlEscape(tc->m_tpath) << "\" class=\"table_summary\">\n"
+             << " <col width=\"200px\" />\n"
+             << " <col />\n"
+             << " <col width=\"100px\" />\n"
+             << " <col width=\"30%\" />\n"
+             << "  <tr>\n"
+             << "    <td style=\"text-align: left;\" class=\"tablecell_title\">" << xmlEscape(tc->m_tpath) << "</td>\n"
+             << "    <td class=\"tablecell_title\">Step</td>\n"
+             << "    <td class=\"tablecell_title\">" << printTime(tc->m_time) << "</td>\n"
+             << "    <td class=\"tablecell_title\"></td>\n"
+             << "  </tr>\n";
+
+         double rest = tc->m_time;
+         auto row = [&](const string & name, const string & step, double t, bool ok)
+         {
+            const double share = tc->m_time > 0 ? min(1.0, t / tc->m_time) : 0.0;
+            oss << "  <tr>\n"
+                << "    <td style=\"text-align:left;\" class=\"tablecell_" << (ok ? "left" : "lefterror") << "\">" << name << "</td>\n"
+                << "    <td style=\"text-align:left;\" class=\"tablecell_left\">" << xmlEscape(step) << "</td>\n"
+                << "    <td class=\"tablecell_success\">" << printTime(t) << "</td>\n"
+                << "    <td class=\"tablecell_left\"><div style=\"background-color: #cc33cc; height: 10px; width: "
+                << fixed << setprecision(1) << share * 100 << "%;\"></div></td>\n"
+                << "  </tr>\n";
+            oss.unsetf(ios::fixed);
+         };
+
+         for( auto & ts : tc->m_tstep )
+         {
+            if( ts.first.compare(0, 3, "TC-") == 0 )
+            {
+               continue;
+            }
+            row(ts.first, ts.second.m_step, ts.second.m_time, ts.second.m_OK);
+            rest -= ts.second.m_time;
+         }
+         if( rest > 0 )
+         {
+            row("(after the last step)", "", rest, true);
+         }
+         oss << "</table>\n";
+      }
+
+      line.replace(pos, 9, oss.str());
+   }
+
+   void Manager::genSumSuites(const string::size_type pos, string & line)
+   {
+      string name;
+
+      ostringstream oss;
+
+      for( auto & i : m_suites )
+      {
+         oss << "  <tr>\n";
+
+         oss << "    <td style=\"text-align:left;\" class=\"tablecell_" << isError(i.second.m_tc_FAIL) << "\"><a href=\"#"
+             << i.second.m_name << "\">" << i.second.m_name << "</a></td>\n";
+
+         oss << "    <td class=\"tablecell_success\">"
+             <<  i.second.m_tc_OK + i.second.m_tc_FAIL + i.second.m_tc_DISABLED << "</td>\n";
+
+         oss << "    <td class=\"tablecell_" << isWarn( i.second.m_tc_DISABLED ) << "\">"
+             <<  i.second.m_tc_OK + i.second.m_tc_FAIL << "</td>\n";
+
+         oss << "    <td class=\"tablecell_success\">"
+             <<  i.second.m_tc_OK << "</td>\n";
+
+         oss << "    <td class=\"tablecell_success\">"
+             <<  setprecision(3);
+         if( i.second.m_tc_OK + i.second.m_tc_FAIL < 1 )
+         {
+            oss << 0.0;
+         } else {
+            oss << i.second.m_tc_OK * 100.0 / ( i.second.m_tc_OK + i.second.m_tc_FAIL );
+         }
+         oss << "</td>\n";
+
+         oss << "    <td class=\"tablecell_" << isWarn( i.second.m_tc_DISABLED ) << "\">"
+             <<  i.second.m_tc_DISABLED << "</td>\n";
+
+         oss << "    <td class=\"tablecell_" << isWarn( i.second.m_tc_DISABLED ) << "\">"
+             <<  setprecision(3) << i.second.m_tc_DISABLED * 100.0 / ( i.second.m_tc_OK + i.second.m_tc_FAIL + i.second.m_tc_DISABLED ) << "</td>\n";
+
+         oss << "    <td class=\"tablecell_" << isError( i.second.m_tc_FAIL ) << "\">"
+             <<  i.second.m_tc_FAIL << "</td>\n";
+
+         oss << "    <td class=\"tablecell_" << isError( i.second.m_tc_FAIL ) << "\">"
+             <<  setprecision(3);
+
+         if(  i.second.m_tc_OK + i.second.m_tc_FAIL < 1 )
+         {
+            oss << 0.0;
+         } else {
+            oss << i.second.m_tc_FAIL * 100.0 / ( i.second.m_tc_OK + i.second.m_tc_FAIL );
+         }
+         oss << "</td>\n";
+
+         double t=0;
+         for( auto & tc : i.second.m_tcs )
+         {
+            t += tc.second.m_time;
+         }
+
+         oss << "    <td class=\"tablecell_success\">"
+             << printTime(t) << "</td>\n" << "  </tr>\n";
+      }
+
+      line.replace(pos, 12, oss.str());
+   }
+
+   void Manager::genGtime(const string::size_type pos, string & line)
+   {
+      ostringstream oss;
+
+      time_t rawtime;
+      struct tm * timeinfo;
+      char buffer[200];
+
+      time(&rawtime);
+      timeinfo = localtime(&rawtime);
+      strftime( buffer, 80, "%Y-%m-%d  %H:%M:%S  %Z", timeinfo);
+
+      oss << "<div style=\"border: 0px;font-size: 13px; font-family: monospace; text-align: center;\">generation time: "
+          << buffer << "</div>\n";
+
+      getcwd(buffer,200);
+
+      oss << "<div style=\"border: 0px;font-size: 13px; font-family: monospace; text-align: center;\">"
+          << buffer << "</div>\n";
+
+      oss << "<div style=\"border: 0px;font-size: 13px; font-family: monospace; text-align: center;\">"
+          << xmlEscape(m_host.text()) << "</div>\n";
+
+      line.replace(pos, 7, oss.str());
+   }
+
+   void Manager::genTestResults(const string::size_type pos, string & line)
+   {
+      string insHtml;
+      insHtml.reserve(10000);
+      bool failFound = false;
+
+      string name;
+      ostringstream oss;
+
+      for( auto & s : m_suites )
+      {
+         for( auto & tc : s.second.m_tcs )
+         {
+            if( tc.second.m_ts_FAIL > 0 or m_ts_all )
+            {
+               if( !failFound)
+               {
+                  oss << "<h2>Test result details - Test steps</h2>\n";
+                  failFound = true;
+               }
+
+               auto p = m_fmap.find(tc.second.m_tpath);
+
+               for( auto & ts : tc.second.m_tstep )
+               {
+                  if( !ts.second.m_OK or m_ts_all )
+                  {
+                     oss << "<h3><a name=\"" << s.second.m_name << "_" << tc.second.m_name << "\">"
+                         << s.second.m_name << "::" << tc.second.m_name << "</a></h3>\n";
+
+                     oss << "<table style=\"table-layout: fixed;\" summary=\"Test Failure\" class=\"table_result\">\n"
+                         << " <col width=\"100px\" />\n"
+                         << "<tr>\n" << "<td style=\"text-align:left;\" class=\"tablecell_title\">Testcase</td>\n"
+                         << "<td class=\"tablecell_left\">" <<  s.second.m_name << "::" << tc.second.m_name
+                         << "</td>\n</tr>\n";
+
+                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Descript.</td>"
+                         << "    <td class=\"tablecell_left\">";
+
+                     //oss << p->second.m_desc <<  "</td>\n  </tr>";
+                     oss <<ts.second.m_desc <<  "</td>\n  </tr>";
+
+
+                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">File</td>"
+                         << "    <td class=\"tablecell_left\">";
+                     oss << p->second.m_fname << ":" << p->second.m_line << "</td>\n  </tr>\n";
+
+
+                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Test Step</td>"
+                         << "    <td class=\"tablecell_left\">" << ts.first << "</td></tr>\n";
+
+                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Status</td>"
+                         << "    <td class=\"tablecell_left";
+                     if( ts.second.m_OK )
+                     {
+                        oss << "\">OK.";
+                     } else {
+                        oss << "error\">FAILED.";
+                     }
+                     oss << "</td></tr>\n";
+
+                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Message</td>"
+                         << "    <td class=\"tablecell_left\">" << ts.second.m_msg <<  "</td>\n  </tr>";
+
+                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Expected</td>"
+                         << "    <td class=\"tablecell_left\">";
+
+                     if( ts.second.m_EX_expected.size() > 0 )
+                     {
+                        oss << ts.second.m_EX_expected;
+                     } else {
+                        oss << ts.second.m_expect;
+                     }
+                     oss <<  "</td>\n  </tr>";
+
+
+                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Actual</td>"
+                         << "    <td class=\"tablecell_left\">";
+
+                     if( ts.second.m_EX_happened.size() > 0 )
+                     {
+                        oss << ts.second.m_EX_happened;
+                     } else {
+                        oss << ts.second.m_actual;
+                     }
+                     oss <<  "</td>\n  </tr>\n";
+
+                     // what
+                     if( ts.second.m_what.size() > 0 )
+                     {
+                        oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">What</td>"
+                            << "    <td class=\"tablecell_left\">";
+
+                        oss << ts.second.m_what;
+                        oss <<  "</td>\n  </tr>\n";
+                     }
+
+                     if( ts.second.m_backtrace.size() > 0 )
+                     {
+                        oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Backtrace</td>"
+                            << "    <td class=\"tablecell_left\"><pre>" << xmlEscape(ts.second.m_backtrace)
+                            << "</pre></td>\n  </tr>\n";
+                     }
+
+                     oss << "</table>\n";
+                     oss << "<p class=\"spaced\"><a href=\"#top\">Back to top</a></p>\n";
+                     oss << "<hr />\n";
+                  }
+               }
+
+               if( tc.second.m_output.size() > 0 )
+               {
+                  oss << "<h3>" << s.second.m_name << "::" << tc.second.m_name << " - Output</h3>\n"
+                      << "<table style=\"table-layout: fixed;\" summary=\"Test Output\" class=\"table_result\">\n"
+                      << " <col width=\"100px\" />\n"
+                      << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">stdout/stderr</td>"
+                      << "    <td class=\"tablecell_left\"><pre>" << xmlEscape(tc.second.m_output)
+                      << "</pre></td>\n  </tr>\n</table>\n"
+                      << "<p class=\"spaced\"><a href=\"#top\">Back to top</a></p>\n"
+                      << "<hr />\n";
+               }
+               insHtml += oss.str();
+               oss.str("");
+               oss.clear();
+            }
+         }
+      }
+
+      line.replace(pos, 13, insHtml);
+   }
+
+   void Manager::genHTML()
+   {
+      TraceSpan span("genHTML");
+
+      ::mkdir("tmp", 0774);
+
+      ofstream of("tmp/results.html");
+      string::size_type pos;
+
+      for( auto & i : s_html )
+      {
+         string line(i);
+         pos = 10;
+
+         while( pos != string::npos)
+         {
+            pos = line.find("$GTIME$");
+            if( pos != string::npos )
+            {
+               genGtime(pos, line);
+               continue;
+            }
+
+            pos = line.find("$TITLE$");
+            if( pos != string::npos )
+            {
+               line.replace(pos, 7, m_title);
+               continue;
+            }
+
+            pos = line.find("$SUMMARY$");
+            if( pos != string::npos )
+            {
+               genSummary(pos, line);
+               continue;
+            }
+
+            pos = line.find("$SUMMARY-2$");
+            if( pos != string::npos )
+            {
+               genSummary2(pos, line);
+               continue;
+            }
+
+            pos = line.find("$SUM-SUITES$");
+            if( pos != string::npos )
+            {
+               genSumSuites(pos, line);
+               continue;
+            }
+
+            pos = line.find("$FIXTURES$");
+            if( pos != string::npos )
+            {
+               genFixtures(pos, line);
+               continue;
+            }
+
+            pos = line.find("$SUITES$");
+            if( pos != string::npos )
+            {
+               genSuites(pos, line);
+               continue;
+            }
+
+            pos = line.find("$SLOWEST$");
+            if( pos != string::npos )
+            {
+               genSlowest(pos, line);
+               continue;
+            }
+
+            pos = line.find("$TESTRESULTS$");
+            if( pos != string::npos )
+            {
+               genTestResults(pos, line);
+               continue;
+            }
+
+         };
+
+         of << line << "\n";
+      }
+      cout << "<tmp/results.html> generated." << endl;
+   }
+
+   void Manager::tc_disabled(const UT::Probe & probe)
+   {
+      cout << "INFO: Test " << probe.m_tpath
+           << " skipped because of filter condition <"
+           << m_filter << ">" << endl;
+
+      auto p = m_suites.find(probe.m_suite);
+      if( p == m_suites.end() )
+      {
+         throw runtime_error("Suite not found !");
+      }
+
+      Suite & suite = p->second;
+
+      auto p_tc = suite.m_tcs.find(probe.m_tname);
+      if( p_tc == suite.m_tcs.end() )
+      {
+         throw runtime_error("Testcase not found !");
+      }
+
+      p_tc->second.m_disabled = true;
+   }
+
+   PerfCounters & Manager::counters()
+   {
+      // perf events count the opening thread only, so every worker has its own;
+      // opened once, a failed open is not tried again before every testcase
+      thread_local PerfCounters c;
+      thread_local bool opened = false;
+      if( !opened )
+      {
+         opened = true;
+         c.open();
+      }
+      return c;
+   }
+
+   // worker j (the main thread is 0) on its cpu of --cpus. With -j the main thread
+   // shares m_cpus[0] with worker 0, but only waits for the workers there
+   void Manager::pin( int j )
+   {
+      if( m_cpus.size() > 0 )
+      {
+         pinThread(m_cpus[j % m_cpus.size()]);
+      }
+   }
+
+   void Manager::startClock(timespec & t, Usage & u)
+   {
+      u = Usage::begin();
+      if( m_perf )
+      {
+         counters().start();
+      }
+      clock_gettime(CLOCK_MONOTONIC, &t);
+   }
+
+   void Manager::stopClock(timespec & t, const Usage & u, Testcase & tc)
+   {
+      clock_gettime(CLOCK_MONOTONIC, &t);
+      if( m_perf )
+      {
+         counters().stop(tc.m_perf);
+      }
+      tc.m_usage = Usage::end() - u;
+   }
+
+   void Manager::exec()
+   {
+      TraceSpan span("exec");
+
+      m_deadline = m_budget > 0 ? monotonic() + m_budget : 0.0;
+      m_host = Host::probe();   // before pin(0): the cpus the process may run on
+      pin(0);
+      if( m_cpus.size() > 0 || m_repeat > 1 )
+      {
+         cout << "INFO: host: " << m_host.text() << endl;
+      }
+
+      if( m_perf )
+      {
+         if( counters().isOpen() )
+         {
+            m_perf_names = counters().names();
+            cout << "INFO: perf counters:";
+            for( auto & n : m_perf_names )
+            {
+               cout << " " << n;
+            }
+            cout << endl;
+         } else {
+            cerr << "WARNING: perf_event_open() failed (" << strerror(errno)
+                 << "), perf counters disabled." << endl;
+            m_perf = false;
+         }
+      }
+
+      vector<UT::Probe *> probes;
+
+      for( auto & i : m_fmap )
+      {
+         if( m_only_module.size() > 0 && findTC(i.second).m_module != m_only_module )
+         {
+            continue;
+         }
+
+         if( i.first.find(m_filter) == string::npos )
+         {
+            tc_disabled(i.second);
+            continue;
+         }
+
+         if( !i.second.m_disabled )
+         {
+            probes.push_back(&i.second);
+            auto & tc = findTC(i.second);
+            tc.clear();
+            tc.m_quarantined = any_of(m_quarantine.begin(), m_quarantine.end(),
+                                      [&](const string & q) { return inScope(q, i.first); });
+         }
+      }
+
+      loadHistory();
+      if( m_budget > 0 )
+      {
+         prioritize(probes);
+      }
+
+      fixturesInit(probes);
+
+      if( m_capture )
+      {
+         s_capture.start();
+      }
+
+      for( m_round = 1; m_round <= m_repeat; ++m_round )
+      {
+         if( m_round > 1 && m_deadline > 0 && monotonic() >= m_deadline )
+         {
+            cout << "INFO: time budget used up after " << m_round - 1 << " round(s)." << endl;
+            break;
+         }
+
+         if( m_repeat > 1 )
+         {
+            cout << "INFO: round " << m_round << endl;
+         }
+
+         const double begin = monotonic();
+         int failed = runAll(probes);
+         failed = retry(probes, failed);
+         s_tracer.span("round " + to_string(m_round), "phase", begin, monotonic());
+
+         if( m_until_fail && failed > 0 )
+         {
+            cout << "INFO: " << failed << " testcase(s) failed in round " << m_round
+                 << ", stopping (--until-fail)." << endl;
+            break;
+         }
+      }
+
+      if( m_capture )
+      {
+         s_capture.stop();
+      }
+
+      // --until-fail stopped early
+      for( auto f : m_fixtures )
+      {
+         if( !m_resident )
+         {
+            f->release();
+         }
+      }
+
+      for( auto p : probes )
+      {
+         findTC(*p).finish();
+      }
+
+      saveHistory();
+   }
+
+   // runs every probe once, with m_jobs threads; returns the number of failed testcases
+   int Manager::runAll( const vector<UT::Probe *> & probes )
+   {
+      if( m_depends.size() > 0 )
+      {
+         return runGraph(probes);
+      }
+
+      // the ASYNC_TESTs share an event loop in this thread, after the others
+      if( any_of(probes.begin(), probes.end(), [](const UT::Probe * p) { return bool(p->m_async); }) )
+      {
+         vector<UT::Probe *> sync;
+         vector<UT::Probe *> async;
+         for( auto p : probes )
+         {
+            (p->m_async ? async : sync).push_back(p);
+         }
+         return runAll(sync) + runAsync(async);
+      }
+
+      atomic<size_t> next(0);
+      atomic<int> failed(0);
+      exception_ptr error;
+
+      // workers take batches, many tiny testcases (TEST_PARAM rows) would
+      // otherwise fight over the counter
+      const size_t batch = max<size_t>(1, probes.size() / (m_jobs * 16));
+
+      auto worker = [&]()
+      {
+         try
+         {
+            size_t k;
+            while( (k = next.fetch_add(batch)) < probes.size() )
+            {
+               for( size_t e = min(k + batch, probes.size()); k < e; ++k )
+               {
+                  if( !run(*probes[k]) )
+                  {
+                     failed++;
+                  }
+               }
+            }
+         }
+         catch( ... )
+         {
+            lock_guard<mutex> lock(m_mutex);
+            error = current_exception();
+            next = probes.size();
+         }
+      };
+
+      if( m_jobs < 2 || probes.size() < 2 )
+      {
+         worker();
+      } else {
+         vector<thread> workers;
+         for( int j = 0; j < m_jobs; ++j )
+         {
+            workers.push_back( thread([&, j]() { s_tracer.track(j + 1); pin(j); worker(); }) );
+         }
+         for( auto & w : workers )
+         {
+            w.join();
+         }
+      }
+
+      if( error )
+      {
+         rethrow_exception(error);
+      }
+
+      return failed;
+   }
+
+   // --retries: what failed in this round runs again, up to m_retries times, the
+   // testcases in parallel with -j; one that passes a retry is FLAKY (counted as OK),
+   // one that never does failed in this round. The DEPENDS dependents it got skipped
+   // run with the next pass. Returns the number still failed
+   int Manager::retry( const vector<UT::Probe *> & probes, int failed )
+   {
+      if( m_retries == 0 )
+      {
+         return failed;
+      }
+
+      // skipped for a prerequisite in `passed` (or for one of theirs), whose other
+      // prerequisites passed as well; a skipped one does not count as passed, as in runGraph
+      auto blocked = [&](const vector<UT::Probe *> & passed)
+      {
+         set<const UT::Probe *> done(passed.begin(), passed.end());
+         auto ready = [&](const UT::Probe * q)
+         {
+            for( auto & d : m_depends )
+            {
+               if( !inScope(d.m_tpath, q->m_tpath) )
+               {
+                  continue;
+               }
+               for( auto p : probes )
+               {
+                  const auto & tc = findTC(*p);
+                  if( p != q && inScope(d.m_prerequisite, p->m_tpath) && done.count(p) == 0
+                      && (!tc.m_last_ok || !tc.m_skipped.empty()) )
+                  {
+                     return false;
+                  }
+               }
+            }
+            return true;
+         };
+
+         vector<UT::Probe *> rc;
+         for( bool more = true; more; )
+         {
+            more = false;
+            for( auto & d : m_depends )
+            {
+               if( none_of(done.begin(), done.end(), [&](const UT::Probe * p) { return inScope(d.m_prerequisite, p->m_tpath); }) )
+               {
+                  continue;
+               }
+               for( auto q : probes )
+               {
+                  // runGraph's reason: "prerequisite ... failed" (or "was skipped")
+                  const auto & tc = findTC(*q);
+                  if( inScope(d.m_tpath, q->m_tpath) && tc.m_skipped.compare(0, 13, "prerequisite ") == 0
+                      && done.count(q) == 0 && ready(q) )
+                  {
+                     done.insert(q);
+                     rc.push_back(q);
+                     more = true;
+                  }
+               }
+            }
+         }
+         return rc;
+      };
+
+      vector<UT::Probe *> again;
+      for( auto p : probes )
+      {
+         if( !findTC(*p).m_last_ok )
+         {
+            again.push_back(p);
+         }
+      }
+      vector<UT::Probe *> unblocked;
+
+      for( int r = 1; again.size() + unblocked.size() > 0; ++r )
+      {
+         // the last retry passed: one more pass for the dependents only
+         if( r > m_retries )
+         {
+            if( unblocked.empty() )
+            {
+               break;
+            }
+            again.clear();
+         }
+
+         if( r <= m_retries )
+         {
+            cout << "INFO: retry " << r << " of " << m_retries << ": " << again.size() << " testcase(s)";
+         } else {
+            cout << "INFO: after the retries";
+         }
+         if( unblocked.size() > 0 )
+         {
+            cout << ", " << unblocked.size() << " skipped dependent(s)";
+         }
+         cout << endl;
+
+         vector<UT::Probe *> pass = again;
+         for( auto p : again )
+         {
+            findTC(*p).m_retried++;
+         }
+         for( auto p : unblocked )
+         {
+            findTC(*p).m_skipped = "";
+            pass.push_back(p);
+         }
+         runAll(pass);
+
+         vector<UT::Probe *> recovered;
+         for( auto p : again )
+         {
+            if( findTC(*p).m_last_ok )
+            {
+               recovered.push_back(p);
+            }
+         }
+
+         vector<UT::Probe *> left;
+         for( auto p : pass )
+         {
+            const auto & tc = findTC(*p);
+            if( !tc.m_last_ok && tc.m_skipped.empty() )
+            {
+               left.push_back(p);
+            }
+         }
+         again.swap(left);
+         unblocked = blocked(recovered);
+      }
+
+      for( auto p : again )
+      {
+         findTC(*p).m_unrecovered++;
+      }
+      return again.size();
+   }
+
+   // executes the testcase once; returns true if it passed
+   // CRASHES: without --catch-signals it would take the run down with it, skipped
+   bool Manager::crashing( const UT::Probe & probe )
+   {
+      if( !m_signals )
+      {
+         for( auto & c : m_crashes )
+         {
+            if( inScope(c.first, probe.m_tpath) )
+            {
+               skip(probe, "crashes on purpose, runs with --catch-signals");
+               return true;
+            }
+         }
+      }
+      return false;
+   }
+
+   bool Manager::run( UT::Probe & probe )
+   {
+      if( probe.m_async )
+      {
+         return runAsync(vector<UT::Probe *>(1, &probe)) == 0;
+      }
+
+      if( overBudget(probe) || crashing(probe) )
+      {
+         return true;
+      }
+
+      // --cold: a run after evicting the caches, then a warm one
+      bool ok = true;
+      if( m_cold )
+      {
+         ok = runOnce(probe, true);
+      }
+      ok = runOnce(probe, false) && ok;
+
+      // after both runs of --cold, a fixture is torn down once
+      fixturesDone(probe);
+      return ok;
+   }
+
+   bool Manager::runOnce( UT::Probe & probe, bool cold )
+   {
+      string what;
+      string backtrace;
+
+      timespec t1,t2, tdiff = {0};
+      Usage u;
+
+      auto & tc = findTC(probe);
+
+      tc.start();
+      probe.m_origin->reset();
+      t_probe = &probe;
+      t_setup_time = 0.0;
+
+      UT::ClockState clock;
+      ClockScope scope(clock);
+
+      Output out;
+      if( s_capture.active() )
+      {
+         s_capture.begin(out);
+      }
+
+      try
+      {
+         auto body = [&]()
+         {
+            if( probe.m_fuzz )
+            {
+               replay(probe, tc);
+            } else {
+               probe.m_func();
+            }
+         };
+
+         if( cold )
+         {
+            TraceSpan span("evict caches");
+            s_evictor.evict();
+         }
+         startClock(t1, u);
+         t_step_mark = StepClock::get().now();
+         const int sig = m_signals ? guarded(body) : (body(), 0);
+         stopClock(t2, u, tc);
+
+         if( sig != 0 )
+         {
+            tc.m_is_EX_happened = true;
+            tc.m_EX_happened = "signal " + signalName(sig);
+            what = strsignal(sig);
+            backtrace = crashBacktrace();
+
+            lock_guard<mutex> lock(m_mutex);
+            console() << "CRASHED: <" << tc.m_name << "> - " << signalName(sig) << endl;
+         }
+      }
+      catch( const exception & e )
+      {
+         stopClock(t2, u, tc);
+         tc.m_is_EX_happened = true;
+         tc.m_EX_happened = typeIdName(e);
+         what = e.what();
+      }
+      catch(...)
+      {
+         stopClock(t2, u, tc);
+         tc.m_is_EX_happened = true;
+         tc.m_EX_happened = "(UNKNOWN)>";
+      }
+
+      if( s_capture.active() )
+      {
+         s_capture.end(out);
+      }
+
+      tdiff = diff(t1, t2);
+      // building a fixture is reported with the fixture
+      tc.m_time = tdiff.tv_sec + tdiff.tv_nsec / 1000000000.0 - t_setup_time;
+      tc.m_sim_time = chrono::duration<double>(clock.m_now).count();
+      t_probe = nullptr;
+
+      exceptionStep(tc, what, backtrace);
+
+      const bool ok = tc.stop(cold);
+      keepOutput(tc, ok, out, cold);
+      s_tracer.span(tc.m_tpath, "testcase", seconds(t1), seconds(t2),
+                    string("\"ok\":") + (ok ? "true" : "false") + ",\"round\":" + to_string(m_round)
+                    + (cold ? ",\"cold\":true" : ""));
+      return ok;
+   }
+
+   // --capture: the output of the first failed run (--cold: of its cold half, if that
+   // failed), with -a of the last run if none failed
+   void Manager::keepOutput( Testcase & tc, bool ok, const Output & out, bool cold )
+   {
+      const bool first = cold ? tc.m_runs == tc.m_runs_OK : tc.m_runs - tc.m_runs_OK == 1 && tc.m_cold_ok;
+      if( (!ok && first) || (m_ts_all && tc.m_runs_OK == tc.m_runs) )
+      {
+         tc.m_output = out.text();
+      }
+   }
+
+   // the exception (or crash) that ended a run is reported as one more step
+   void Manager::exceptionStep( Testcase & tc, const string & what, const string & backtrace )
+   {
+      if( tc.m_is_EX_happened )
+      {
+         Teststep ts;
+         ts.m_OK = tc.m_EX_expected == tc.m_EX_happened;
+         ts.m_desc = "<kbd><b>internally generated Teststep</b> for Testcase exception check</kbd>";
+
+         if( tc.m_EX_expected == "" )
+         {
+            ts.m_EX_expected = "NO exception";
+         } else {
+            ts.m_EX_expected = tc.m_EX_expected;
+         }
+
+         if( tc.m_EX_happened == "" )
+         {
+            ts.m_EX_happened = "UNKNOWN exception.";
+         } else {
+            ts.m_EX_happened = tc.m_EX_happened;
+         }
+
+         ts.m_what = what;
+         ts.m_backtrace = backtrace;
+
+         tc.m_tstep.insert(make_pair( "TC-intern", ts));
+      }
+   }
+
+   // ASYNC_TESTs: each body runs (up to its first wait) one after the other, then
+   // their callbacks are multiplexed on one loop until all of them are done;
+   // returns the number of failed testcases
+   // ok: per probe, false if it failed (true if it did not run)
+   int Manager::runAsync( const vector<UT::Probe *> & probes, vector<bool> * ok )
+   {
+      UT::AsyncLoop loop(m_signals);
+      vector< unique_ptr<UT::Async> > tests;
+      int failed = 0;
+
+      if( ok != nullptr )
+      {
+         ok->assign(probes.size(), true);
+      }
+
+      loop.m_complete = [&](UT::Async & as)
+      {
+         if( !completeAsync(as) )
+         {
+            failed++;
+            if( ok != nullptr )
+            {
+               (*ok)[find(probes.begin(), probes.end(), &as.m_probe) - probes.begin()] = false;
+            }
+         }
+      };
+
+      for( auto p : probes )
+      {
+         if( overBudget(*p) || crashing(*p) )
+         {
+            continue;
+         }
+
+         findTC(*p).start();
+         p->m_origin->reset();
+
+         tests.emplace_back(new UT::Async(loop, *p));
+         UT::Async & as = *tests.back();
+         loop.m_open++;
+         as.m_start = monotonic();
+         as.timeout(m_async_timeout);
+         loop.call(as, [&]() { p->m_async(as); });
+      }
+
+      while( loop.m_open > 0 )
+      {
+         loop.once();
+      }
+
+      return failed;
+   }
+
+   // the time of an ASYNC_TEST is from its start to done(), waiting included;
+   // it shares the thread with the others, it has no usage or perf counters
+   bool Manager::completeAsync( UT::Async & as )
+   {
+      UT::Probe & probe = as.m_probe;
+      auto & tc = findTC(probe);
+      string what;
+
+      if( as.m_error )
+      {
+         tc.m_is_EX_happened = true;
+         try
+         {
+            rethrow_exception(as.m_error);
+         }
+         catch( const exception & e )
+         {
+            tc.m_EX_happened = typeIdName(e);
+            what = e.what();
+         }
+         catch(...)
+         {
+            tc.m_EX_happened = "(UNKNOWN)>";
+         }
+      } else if( as.m_sig != 0 ) {
+         tc.m_is_EX_happened = true;
+         tc.m_EX_happened = "signal " + signalName(as.m_sig);
+         what = strsignal(as.m_sig);
+
+         lock_guard<mutex> lock(m_mutex);
+         console() << "CRASHED: <" << tc.m_name << "> - " << signalName(as.m_sig) << endl;
+      }
+
+      if( as.m_timedout )
+      {
+         Teststep ts;
+         ts.m_OK = false;
+         ts.m_desc = "<kbd><b>internally generated Teststep</b> for the ASYNC_TEST timeout</kbd>";
+         ostringstream oss;
+         oss << "not done after " << setprecision(3) << as.m_end - as.m_start << " s";
+         ts.m_msg = oss.str();
+         tc.m_tstep.insert(make_pair( "TC-timeout", ts));
+
+         lock_guard<mutex> lock(m_mutex);
+         console() << "TIMEOUT: <" << tc.m_name << "> - " << ts.m_msg << endl;
+      }
+
+      tc.m_time = as.m_end - as.m_start - as.m_setup_time;
+      tc.m_sim_time = chrono::duration<double>(as.m_clock.m_now).count();
+      tc.m_usage = Usage();
+
+      fixturesDone(probe);
+      exceptionStep(tc, what, as.m_backtrace);
+
+      const bool ok = tc.stop();
+      keepOutput(tc, ok, as.m_loop.m_outputs[&as]);
+      // ASYNC_TESTs overlap on the main thread's track
+      s_tracer.span(tc.m_tpath, "async", as.m_start, as.m_end,
+                    string("\"ok\":") + (ok ? "true" : "false") + ",\"round\":" + to_string(m_round),
+                    true);
+      return ok;
+   }
+
+   // --resident: a module is a shared object of test files (-fPIC -shared); its
+   // TEST_CASEs, FIXTUREs and DEPENDS register themselves while it is loaded
+   bool Manager::load( const string & module )
+   {
+      // a fresh copy each time: dlopen() of a loaded path returns the old image,
+      // and the build may overwrite the file while it is in use
+      static int generation = 0;
+      const auto image = readFile(module);
+      if( image.empty() )
+      {
+         cerr << "ERROR: can't read module <" << module << ">" << endl;
+         return false;
+      }
+
+      makeDirs("tmp/modules");
+      const string copy = "tmp/modules/" + to_string(++generation) + "-" + module.substr(module.find_last_of('/') + 1);
+      writeFile(copy, image);
+
+      m_loading = module;
+      void * handle = dlopen(copy.c_str(), RTLD_NOW | RTLD_LOCAL);
+      m_loading = "";
+      unlink(copy.c_str());
+
+      if( handle == nullptr )
+      {
+         cerr << "ERROR: " << dlerror() << endl;
+         return false;
+      }
+
+      m_handles[module] = handle;
+      return true;
+   }
+
+   void Manager::unload( const string & module )
+   {
+      auto h = m_handles.find(module);
+      if( h == m_handles.end() )
+      {
+         return;
+      }
+
+      for( auto s = m_suites.begin(); s != m_suites.end(); )
+      {
+         auto & tcs = s->second.m_tcs;
+         for( auto t = tcs.begin(); t != tcs.end(); )
+         {
+            if( t->second.m_module == module )
+            {
+               m_fmap.erase(t->second.m_tpath);
+               t = tcs.erase(t);
+            } else {
+               ++t;
+            }
+         }
+         s = tcs.empty() ? m_suites.erase(s) : next(s);
+      }
+
+      m_depends.erase(remove_if(m_depends.begin(), m_depends.end(),
+                                [&](const Dependency & d) { return d.m_module == module; }),
+                      m_depends.end());
+      for( auto c = m_crashes.begin(); c != m_crashes.end(); )
+      {
+         c = c->second == module ? m_crashes.erase(c) : next(c);
+      }
+      forgetTypeNames();
+
+      // runs the destructors of its statics, its FIXTUREs unsubscribe
+      dlclose(h->second);
+      m_handles.erase(h);
+   }
+
+   // runs the testcases of module ("": all), then the reports cover all testcases
+   void Manager::report( const string & module )
+   {
+      m_only_module = module;
+      exec();
+      m_only_module = "";
+
+      genStatistics();
+      printSummary();
+      genHTML();
+      genXML();
+   }
+
+   // loads the modules, runs them, then waits: a module that changed on disk
+   // (or is named on stdin) is reloaded and its testcases run again; the
+   // fixtures of the others stay alive
+   int Manager::resident()
+   {
+      m_resident = true;
+
+      const int in = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+      if( in < 0 )
+      {
+         throw runtime_error(string("inotify_init1: ") + strerror(errno));
+      }
+
+      map<int, string> dirs;   // watch -> directory
+      auto dirOf = [](const string & m) { return m.find('/') == string::npos ? string(".") : m.substr(0, m.find_last_of('/')); };
+      auto baseOf = [](const string & m) { return m.substr(m.find_last_of('/') + 1); };
+
+      for( auto & m : m_modules )
+      {
+         load(m);
+
+         // the directory: a linker replaces the file
+         const int wd = inotify_add_watch(in, dirOf(m).c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+         if( wd < 0 )
+         {
+            cerr << "WARNING: can't watch <" << dirOf(m) << ">: " << strerror(errno) << endl;
+         } else {
+            dirs[wd] = dirOf(m);
+         }
+      }
+
+      report("");
+
+      bool input = true;
+      while( true )
+      {
+         cout << "INFO: resident, watching " << m_modules.size()
+              << " module(s); <Enter> runs all, <module> reloads it, q quits" << endl;
+
+         pollfd fds[2] = { { in, POLLIN, 0 }, { 0, POLLIN, 0 } };
+         if( poll(fds, input ? 2 : 1, -1) < 0 )
+         {
+            if( errno == EINTR )
+            {
+               continue;
+            }
+            throw runtime_error(string("poll: ") + strerror(errno));
+         }
+
+         set<string> changed;
+
+         if( fds[0].revents & POLLIN )
+         {
+            // a build writes in pieces: until it is quiet for a moment
+            do
+            {
+               char buf[4096] __attribute__((aligned(__alignof__(inotify_event))));
+               ssize_t n;
+               while( (n = read(in, buf, sizeof(buf))) > 0 )
+               {
+                  for( char * e = buf; e < buf + n; )
+                  {
+                     const inotify_event * ev = reinterpret_cast<const inotify_event *>(e);
+                     for( auto & m : m_modules )
+                     {
+                        if( ev->len > 0 && dirs[ev->wd] == dirOf(m) && baseOf(m) == ev->name )
+                        {
+                           changed.insert(m);
+                        }
+                     }
+                     e += sizeof(inotify_event) + ev->len;
+                  }
+               }
+            } while( poll(fds, 1, 200) > 0 );
+         }
+
+         if( input && (fds[1].revents & (POLLIN | POLLHUP)) )
+         {
+            string line;
+            if( !getline(cin, line) )
+            {
+               input = false;    // stdin closed: watch only
+            } else if( line == "q" ) {
+               break;
+            } else if( line.empty() ) {
+               report("");
+            } else if( find(m_modules.begin(), m_modules.end(), line) != m_modules.end() ) {
+               changed.insert(line);
+            } else {
+               cerr << "ERROR: <" << line << "> is not one of the modules" << endl;
+            }
+         }
+
+         for( auto & m : changed )
+         {
+            cout << "INFO: reloading <" << m << ">" << endl;
+            unload(m);
+            if( load(m) )
+            {
+               report(m);
+            }
+         }
+      }
+
+      close(in);
+      for( auto & m : m_modules )
+      {
+         unload(m);
+      }
+      for( auto f : m_fixtures )
+      {
+         f->release();
+      }
+      return 0;
+   }
+
+   void Manager::skip( const UT::Probe & probe, const string & reason )
+   {
+      auto & tc = findTC(probe);
+      tc.m_skipped = reason;
+      fixturesDone(probe);
+
+      lock_guard<mutex> lock(m_mutex);
+      cout << "SKIPPED: <" << tc.m_name << "> - " << reason << endl;
+   }
+
+   // --history: one line per testcase, "runs fails time last_run last_ok tpath"
+   void Manager::loadHistory()
+   {
+      m_history.clear();
+
+      ifstream in(m_history_file);
+      string line;
+      while( getline(in, line) )
+      {
+         istringstream iss(line);
+         History h;
+         string tpath;
+         if( iss >> h.m_runs >> h.m_fails >> h.m_time >> h.m_last_run >> h.m_last_ok && getline(iss >> ws, tpath) )
+         {
+            m_history[tpath] = h;
+         }
+      }
+   }
+
+   // what this exec() ran goes into the history, the others keep theirs
+   void Manager::saveHistory()
+   {
+      const long long now = time(nullptr);
+
+      for( auto & s : m_suites )
+      {
+         for( auto & i : s.second.m_tcs )
+         {
+            const Testcase & tc = i.second;
+            if( tc.m_runs == 0 || tc.m_disabled )
+            {
+               continue;
+            }
+
+            History & h = m_history[tc.m_tpath];
+            h.m_time = h.m_runs == 0 ? tc.m_time : 0.7 * h.m_time + 0.3 * tc.m_time;
+            h.m_runs += tc.m_runs;
+            h.m_fails += tc.m_runs - tc.m_runs_OK;
+            h.m_last_run = now;
+            h.m_last_ok = tc.m_runs_OK == tc.m_runs;
+         }
+      }
+
+      const size_t slash = m_history_file.rfind('/');
+      if( slash != string::npos )
+      {
+         ::mkdir(m_history_file.substr(0, slash).c_str(), 0774);
+      }
+
+      // the old one stays intact until the new one is complete
+      ofstream of(m_history_file + ".new");
+      for( auto & i : m_history )
+      {
+         const History & h = i.second;
+         of << h.m_runs << " " << h.m_fails << " " << setprecision(9) << h.m_time << " "
+            << h.m_last_run << " " << h.m_last_ok << " " << i.first << "\n";
+      }
+      of.close();
+      if( !of || rename((m_history_file + ".new").c_str(), m_history_file.c_str()) != 0 )
+      {
+         cerr << "WARNING: can't write <" << m_history_file << ">: " << strerror(errno) << endl;
+      }
+   }
+
+   // --time-budget: the testcases most likely to find something per second first:
+   //   1. failed in their last run
+   //   2. their source file changed since their last run
+   //   3. never run
+   //   4. the others, by failure rate per second of the history (Laplace smoothed)
+   // in 1. to 3. the fast ones first
+   void Manager::prioritize( vector<UT::Probe *> & probes )
+   {
+      // a testcase without history is expected to take as long as the median one
+      vector<double> times;
+      for( auto & h : m_history )
+      {
+         times.push_back(h.second.m_time);
+      }
+      m_unknown = Stats::of(times).m_median;
+
+      struct Rank
+      {
+            int m_class;
+            double m_key;
+      };
+      map<const UT::Probe *, Rank> rank;
+      int counts[4] = {0, 0, 0, 0};
+
+      for( auto p : probes )
+      {
+         auto h = m_history.find(p->m_tpath);
+         Rank r {3, 0.0};
+         if( h == m_history.end() )
+         {
+            r = Rank{2, m_unknown};
+         } else {
+            struct stat st;
+            if( !h->second.m_last_ok )
+            {
+               r = Rank{0, h->second.m_time};
+            } else if( stat(p->m_fname.c_str(), &st) == 0 && st.st_mtime > h->second.m_last_run ) {
+               r = Rank{1, h->second.m_time};
+            } else {
+               const double rate = (h->second.m_fails + 1.0) / (h->second.m_runs + 2.0);
+               r = Rank{3, -rate / max(h->second.m_time, 1e-4)};
+            }
+         }
+         rank[p] = r;
+         counts[r.m_class]++;
+      }
+
+      stable_sort(probes.begin(), probes.end(), [&](const UT::Probe * a, const UT::Probe * b)
+      {
+         const Rank & ra = rank[a];
+         const Rank & rb = rank[b];
+         return ra.m_class != rb.m_class ? ra.m_class < rb.m_class : ra.m_key < rb.m_key;
+      });
+
+      cout << "INFO: --time-budget " << m_budget << " s, " << probes.size() << " testcases: "
+           << counts[0] << " failed last time, " << counts[1] << " changed, " << counts[2]
+           << " new, " << counts[3] << " by failure rate per second (history: <" << m_history_file << ">)" << endl;
+   }
+
+   // --time-budget: a testcase that would not end before the deadline is not started
+   bool Manager::overBudget( const UT::Probe & probe )
+   {
+      if( m_deadline <= 0.0 )
+      {
+         return false;
+      }
+
+      auto h = m_history.find(probe.m_tpath);
+      const double expected = (h != m_history.end() ? h->second.m_time : m_unknown) * (m_cold ? 2 : 1);
+      const double left = m_deadline - monotonic();
+      if( expected < left )
+      {
+         return false;
+      }
+
+      auto & tc = findTC(probe);
+      if( tc.m_runs == 0 )
+      {
+         ostringstream oss;
+         oss << "time budget: expected " << setprecision(3) << expected << " s, " << max(left, 0.0) << " s left";
+         tc.m_skipped = oss.str();
+         tc.m_budget = true;
+      }
+      fixturesDone(probe);
+      return true;
+   }
+
+   // DEPENDS: a testcase is started once its prerequisites are done, by whichever
+   // worker is free; if one of them failed (or was skipped), it is skipped
+   int Manager::runGraph( const vector<UT::Probe *> & probes )
+   {
+      const size_t n = probes.size();
+      vector< vector<size_t> > next(n);   // the dependents
+      vector<int> pending(n, 0);          // prerequisites not done yet
+
+      for( auto & d : m_depends )
+      {
+         vector<size_t> from, to;
+         for( size_t i = 0; i < n; ++i )
+         {
+            if( inScope(d.m_prerequisite, probes[i]->m_tpath) ) from.push_back(i);
+            if( inScope(d.m_tpath, probes[i]->m_tpath) ) to.push_back(i);
+         }
+         for( auto f : from )
+         {
+            for( auto t : to )
+            {
+               if( f != t ) next[f].push_back(t);
+            }
+         }
+      }
+
+      for( auto & v : next )
+      {
+         sort(v.begin(), v.end());
+         v.erase(unique(v.begin(), v.end()), v.end());
+         for( auto t : v ) pending[t]++;
+      }
+
+      // what can't be reached from the roots is on (or behind) a cycle
+      vector<int> left = pending;
+      vector<size_t> order;
+      for( size_t i = 0; i < n; ++i )
+      {
+         if( left[i] == 0 ) order.push_back(i);
+      }
+      for( size_t k = 0; k < order.size(); ++k )
+      {
+         for( auto t : next[order[k]] )
+         {
+            if( --left[t] == 0 ) order.push_back(t);
+         }
+      }
+
+      mutex mx;
+      condition_variable cv;
+      priority_queue< size_t, vector<size_t>, greater<size_t> > ready;  // the map order among the ready ones
+      vector<string> blocked(n);
+      size_t done = 0;
+      int failed = 0;
+      exception_ptr error;
+
+      for( size_t i = 0; i < n; ++i )
+      {
+         if( left[i] > 0 )
+         {
+            skip(*probes[i], "dependency cycle");
+            done++;
+         } else if( pending[i] == 0 ) {
+            ready.push(i);
+         }
+      }
+
+      // with mx locked
+      auto complete = [&](size_t i, bool ok)
+      {
+         vector< pair<size_t, bool> > todo(1, make_pair(i, ok));
+         while( todo.size() > 0 )
+         {
+            const size_t c = todo.back().first;
+            const bool cok = todo.back().second;
+            todo.pop_back();
+            done++;
+
+            for( auto t : next[c] )
+            {
+               if( !cok && blocked[t].empty() )
+               {
+                  blocked[t] = "prerequisite " + probes[c]->m_tpath +
+                     (findTC(*probes[c]).m_skipped.empty() ? " failed" : " was skipped");
+               }
+
+               if( --pending[t] == 0 && left[t] == 0 )
+               {
+                  if( blocked[t].empty() )
+                  {
+                     ready.push(t);
+                  } else {
+                     skip(*probes[t], blocked[t]);
+                     todo.push_back(make_pair(t, false));
+                  }
+               }
+            }
+         }
+      };
+
+      auto worker = [&]()
+      {
+         unique_lock<mutex> lock(mx);
+         while( true )
+         {
+            cv.wait(lock, [&]() { return ready.size() > 0 || done == n || error; });
+            if( done == n || error )
+            {
+               break;
+            }
+
+            vector<size_t> batch(1, ready.top());
+            ready.pop();
+
+            // the ASYNC_TESTs ready now share one event loop, they wait at the same time
+            if( probes[batch[0]]->m_async )
+            {
+               vector<size_t> rest;
+               while( ready.size() > 0 )
+               {
+                  (probes[ready.top()]->m_async ? batch : rest).push_back(ready.top());
+                  ready.pop();
+               }
+               for( auto r : rest )
+               {
+                  ready.push(r);
+               }
+            }
+            lock.unlock();
+
+            vector<bool> ok(1, false);
+            try
+            {
+               if( probes[batch[0]]->m_async )
+               {
+                  vector<UT::Probe *> async;
+                  for( auto b : batch )
+                  {
+                     async.push_back(probes[b]);
+                  }
+                  runAsync(async, &ok);
+               } else {
+                  ok[0] = run(*probes[batch[0]]);
+               }
+            }
+            catch(...)
+            {
+               lock.lock();
+               error = current_exception();
+               cv.notify_all();
+               break;
+            }
+
+            lock.lock();
+            for( size_t b = 0; b < batch.size(); ++b )
+            {
+               failed += !ok[b];
+               // skipped (--time-budget, CRASHES): its dependents are skipped
+               complete(batch[b], ok[b] && findTC(*probes[batch[b]]).m_skipped.empty());
+            }
+            cv.notify_all();
+         }
+      };
+
+      if( m_jobs < 2 || n < 2 )
+      {
+         worker();
+      } else {
+         vector<thread> workers;
+         for( int j = 0; j < m_jobs; ++j )
+         {
+            workers.push_back( thread([&, j]() { s_tracer.track(j + 1); pin(j); worker(); }) );
+         }
+         for( auto & w : workers )
+         {
+            w.join();
+         }
+      }
+
+      if( error )
+      {
+         rethrow_exception(error);
+      }
+
+      return failed;
+   }
+
+   string Manager::corpusDir( const UT::Probe & probe )
+   {
+      string name = probe.m_tpath;
+      replace(name.begin(), name.end(), '/', '_');
+      if( name.size() > 0 && name[0] == '_' )
+      {
+         name.erase(0, 1);
+      }
+      return m_corpus + "/" + name;
+   }
+
+   // a normal run of a FUZZ_TEST replays the saved inputs: found crashes are regression tests
+   void Manager::replay( UT::Probe & probe, Testcase & tc )
+   {
+      const UT::FuzzTarget & target = *probe.m_fuzz;
+      const string dir = corpusDir(probe);
+      const auto files = listDir(dir);
+
+      if( files.empty() )
+      {
+         const auto in = Mutator(target.m_layout, 1).seed();
+         target.m_func(in.data(), in.size());
+         return;
+      }
+
+      for( auto & f : files )
+      {
+         const auto in = readFile(dir + "/" + f);
+         const string input = "input " + dir + "/" + f + target.m_show(in.data(), in.size());
+         const int before = tc.m_ts_counter;
+
+         Teststep ts;
+         probe.m_origin->reset();
+
+         try
+         {
+            target.m_func(in.data(), in.size());
+         }
+         catch( const exception & e )
+         {
+            ts.m_EX_happened = typeIdName(e);
+            ts.m_what = e.what();
+         }
+         catch(...)
+         {
+            ts.m_EX_happened = "UNKNOWN exception.";
+         }
+
+         for( auto & i : tc.m_tstep )
+         {
+            if( i.second.m_counter > before && !i.second.m_OK )
+            {
+               i.second.m_msg += " [" + input + "]";
+            }
+         }
+
+         if( ts.m_EX_happened.size() > 0 )
+         {
+            ts.m_OK = false;
+            ts.m_desc = "<kbd><b>internally generated Teststep</b> for fuzz input exception check</kbd>";
+            ts.m_msg = input;
+            ts.m_EX_expected = "NO exception";
+            ts.m_counter = ++tc.m_ts_counter;
+
+            ostringstream oss;
+            oss << "TS-" << setfill('0') << setw(3) << ts.m_counter;
+            tc.m_tstep.insert(make_pair(oss.str(), ts));
+
+            lock_guard<mutex> lock(m_mutex);
+            cout << "FAILED: <" << tc.m_name << "> - " << oss.str() << endl;
+         }
+      }
+   }
+
+   // one execution of the target; returns the failure signature, empty if it passed
+   string Manager::fuzzOne( UT::Probe & probe, const vector<unsigned char> & in )
+   {
+      t_fuzz->m_steps = 0;
+      t_fuzz->m_sig = "";
+      probe.m_origin->reset();
+      UT::ClockState clock;
+      ClockScope scope(clock);
+
+      try
+      {
+         auto body = [&]() { probe.m_fuzz->m_func(in.data(), in.size()); };
+         const int sig = guarded(body);
+         if( sig != 0 )
+         {
+            return "signal " + signalName(sig);
+         }
+      }
+      catch( const exception & e )
+      {
+         return "exception " + typeIdName(e);
+      }
+      catch(...)
+      {
+         return "exception (UNKNOWN)";
+      }
+
+      return t_fuzz->m_sig;
+   }
+
+   void Manager::fuzz( UT::Probe & probe )
+   {
+      const UT::FuzzTarget & target = *probe.m_fuzz;
+      const string dir = corpusDir(probe);
+      makeDirs(dir);
+
+      Mutator mutator(target.m_layout, static_cast<uint64_t>(time(nullptr)));
+      vector< vector<unsigned char> > corpus;
+      set<string> crashes;
+
+      for( auto & f : listDir(dir) )
+      {
+         if( f.compare(0, 6, "crash-") != 0 )
+         {
+            corpus.push_back(readFile(dir + "/" + f));
+         }
+      }
+
+      if( corpus.empty() )
+      {
+         corpus.push_back(mutator.seed());
+      }
+
+      FuzzRun fr;
+      t_fuzz = &fr;
+
+      Coverage cov;
+      cov.clear();
+      for( auto & in : corpus )
+      {
+         fuzzOne(probe, in);
+         cov.update();
+      }
+
+      timespec t1, t2, tdiff;
+      clock_gettime(CLOCK_MONOTONIC, &t1);
+      double elapsed = 0.0;
+      double status = 1.0;
+      long long runs = 0;
+
+      for( ; m_fuzz_runs == 0 || runs < m_fuzz_runs; ++runs )
+      {
+         if( (runs & 255) == 0 )
+         {
+            clock_gettime(CLOCK_MONOTONIC, &t2);
+            tdiff = diff(t1, t2);
+            elapsed = tdiff.tv_sec + tdiff.tv_nsec / 1000000000.0;
+
+            if( m_fuzz_runs == 0 && elapsed >= m_fuzz_time )
+            {
+               break;
+            }
+
+            if( elapsed >= status )
+            {
+               cout << "FUZZ: <" << probe.m_tpath << "> " << runs << " runs, "
+                    << static_cast<long long>(runs / elapsed) << " exec/s, corpus " << corpus.size()
+                    << ", edges " << cov.edges() << ", crashes " << crashes.size() << endl;
+               status *= 2;
+            }
+         }
+
+         const auto in = mutator.mutate(corpus[mutator.rnd() % corpus.size()], corpus);
+         const string sig = fuzzOne(probe, in);
+
+         if( sig.size() > 0 )
+         {
+            cov.clear();
+            if( crashes.insert(sig).second )
+            {
+               const string file = dir + "/crash-" + hexHash(in);
+               writeFile(file, in);
+               cout << "FUZZ: <" << probe.m_tpath << "> " << sig << ", arguments"
+                    << target.m_show(in.data(), in.size()) << " saved in <" << file << ">" << endl;
+            }
+            continue;
+         }
+
+         if( cov.update() )
+         {
+            corpus.push_back(in);
+            writeFile(dir + "/id-" + hexHash(in), in);
+         }
+      }
 
-   void Manager::genSuites(const std::string::size_type pos, std::string & line)
+      t_fuzz = nullptr;
+
+      clock_gettime(CLOCK_MONOTONIC, &t2);
+      tdiff = diff(t1, t2);
+      elapsed = tdiff.tv_sec + tdiff.tv_nsec / 1000000000.0;
+
+      cout << "FUZZ: <" << probe.m_tpath << "> done: " << runs << " runs in " << setprecision(3) << elapsed
+           << " s (" << static_cast<long long>(elapsed > 0 ? runs / elapsed : 0) << " exec/s), corpus "
+           << corpus.size() << ", edges " << cov.edges() << ", crashes " << crashes.size() << endl;
+   }
+
+   // --fuzz: generate new inputs for the selected FUZZ_TESTs
+   void Manager::fuzz()
    {
-      ostringstream oss;
-      bool disabled = false;
+      TraceSpan span("fuzz");
 
-      for( auto & s : m_suites )
+      // the executions always run guarded: a crash must not take its input along
+      if( !m_signals )
       {
-         oss << "<h3><a name=\"" << s.second.m_name << "\"></a>Suite: " <<  s.second.m_name << "</h3>\n";
-         oss << "<table style=\"table-layout: fixed;\" summary=\"Details for suite " <<  s.second.m_name << "\" class=\"table_suite\">\n";
-         oss << " <col width=\"200px\" />\n";
-         oss << "  <tr>\n";
-         oss << "    <td style=\"text-align: left;\" class=\"tablecell_title\">Test Case Name</td>\n";
-         oss << "    <td style=\"width:40%\" class=\"tablecell_title\">description</td>\n";
-         oss << "    <td class=\"tablecell_title\">exec'd</td>\n";
-         oss << "    <td colspan=\"2\" class=\"tablecell_title\">OK</td>\n";
-         oss << "    <td colspan=\"2\" class=\"tablecell_title\">FAIL</td>\n";
-         oss << "    <td class=\"tablecell_title\">Time</td>\n";
-         oss << "  </tr>\n";
-         oss << "  <tr>\n";
-         oss << "    <td style=\"text-align: left;\" class=\"tablecell_title\"> </td>\n";
-         oss << "    <td style=\"width:40%\" class=\"tablecell_title\"> </td>\n";
-         oss << "    <td class=\"tablecell_title\">test steps</td>\n";
-         oss << "    <td class=\"tablecell_title\">#</td>\n";
-         oss << "    <td class=\"tablecell_title\">%</td>\n";
-         oss << "    <td class=\"tablecell_title\">#</td>\n";
-         oss << "    <td class=\"tablecell_title\">%</td>\n";
-         oss << "    <td class=\"tablecell_title\">s</td>\n";
-         oss << "  </tr>\n";
+         installCrashHandler();
+      }
 
-         disabled = false;
-         for( auto & tc : s.second.m_tcs )
+      for( auto & i : m_fmap )
+      {
+         if( !i.second.m_fuzz || i.second.m_disabled || i.first.find(m_filter) == string::npos )
          {
-            auto p = m_fmap.find(tc.second.m_tpath);
-            if( p == m_fmap.end() )
+            continue;
+         }
+
+         fuzz(i.second);
+
+         if( !s_cov_used )
+         {
+            cout << "WARNING: no coverage feedback, the code under test is not instrumented"
+                 << " (-fsanitize-coverage=trace-pc, see 'make fuzz')." << endl;
+         }
+      }
+   }
+
+   void Manager::genXML()
+   {
+      TraceSpan span("genXML");
+
+      ::mkdir("tmp", 0774);
+
+      ofstream of("tmp/results.xml");
+
+      of << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+         << "<results title=\"" << xmlEscape(m_title) << "\" suites_ok=\"" << m_su_OK
+         << "\" suites_fail=\"" << m_su_FAIL << "\">\n";
+
+      of << " <host name=\"" << xmlEscape(m_host.m_name)
+         << "\" kernel=\"" << xmlEscape(m_host.m_kernel)
+         << "\" cpu=\"" << xmlEscape(m_host.m_model)
+         << "\" online=\"" << m_host.m_online
+         << "\" nodes=\"" << m_host.m_nodes
+         << "\" smt=\"" << m_host.m_smt
+         << "\" isolated=\"" << m_host.m_isolated
+         << "\" affinity=\"" << m_host.m_affinity
+         << "\" pinned=\"" << printCpuList(m_cpus)
+         << "\" governor=\"" << m_host.m_governor
+         << "\" nice=\"" << m_host.m_nice
+         << "\" loadavg=\"" << m_host.m_loadavg << "\"/>\n";
+
+      for( auto f : m_fixtures )
+      {
+         of << " <fixture name=\"" << xmlEscape(f->m_name)
+            << "\" scope=\"" << xmlEscape(f->m_scope)
+            << "\" testcases=\"" << f->m_users
+            << "\" built_for=\"" << xmlEscape(f->m_first)
+            << "\" setup=\"" << setprecision(9) << f->m_setup_time
+            << "\" teardown=\"" << f->m_teardown_time << "\"/>\n";
+      }
+
+      for( auto & s : m_suites )
+      {
+         of << " <suite name=\"" << xmlEscape(s.second.m_name)
+            << "\" ok=\"" << s.second.m_tc_OK
+            << "\" fail=\"" << s.second.m_tc_FAIL
+            << "\" disabled=\"" << s.second.m_tc_DISABLED
+            << "\" skipped=\"" << s.second.m_tc_SKIPPED
+            << "\" budget=\"" << s.second.m_tc_BUDGET
+            << "\" flaky=\"" << s.second.m_tc_FLAKY
+            << "\" quarantined=\"" << s.second.m_tc_QUARANTINED << "\">\n";
+
+         for( auto & i : s.second.m_tcs )
+         {
+            const Testcase & tc = i.second;
+            const Usage & u = tc.m_usage;
+
+            string status = "OK";
+            if( tc.m_disabled )
             {
-               throw runtime_error("can't find tpath in m_fmap !");
+               status = "DISABLED";
+            } else if( tc.m_runs == 0 && tc.m_skipped.size() > 0 ) {
+               status = tc.m_budget ? "BUDGET" : "SKIPPED";
+            } else if( tc.m_ts_FAIL > 0 ) {
+               status = tc.recovered() ? "FLAKY" : "FAIL";
             }
 
-            if( tc.second.m_disabled )
+            // one line per testcase, the attributes are all there is to know
+            of << "  <testcase name=\"" << xmlEscape(tc.m_name)
+               << "\" tpath=\"" << xmlEscape(tc.m_tpath)
+               << "\" status=\"" << status
+               << (tc.m_skipped.size() > 0 ? "\" skipped=\"" + xmlEscape(tc.m_skipped) : string(""))
+               << (tc.m_quarantined ? "\" quarantined=\"true" : "")
+               << "\" steps_ok=\"" << tc.m_ts_OK
+               << "\" steps_fail=\"" << tc.m_ts_FAIL
+               << "\" time=\"" << setprecision(9) << tc.m_time;
+            if( tc.m_cold_samples.size() > 0 )
             {
-               oss << "  <tr>\n";
-               oss << "    <td style=\"text-align:left;\" class=\"tablecell_warn\">" << tc.second.m_name << "</td>\n";
-               oss << "    <td style=\"text-align:left;\" class=\"tablecell_warn\">" << p->second.m_desc << "</td>\n";
-               oss << "  </tr>\n";
-               disabled = true;
-               continue;
+               of << "\" cold_time=\"" << tc.m_cold_time;
+            }
+            of << (tc.m_sim_time > 0 ? "\" sim_time=\"" + to_string(tc.m_sim_time) : string(""))
+               << "\" cpu_time=\"" << u.m_cpu_time
+               << "\" proc_cpu_time=\"" << u.m_proc_cpu_time
+               << "\" minflt=\"" << u.m_minflt
+               << "\" majflt=\"" << u.m_majflt
+               << "\" nvcsw=\"" << u.m_nvcsw
+               << "\" nivcsw=\"" << u.m_nivcsw
+               << "\" maxrss_kb=\"" << u.m_maxrss
+               << "\" rchar=\"" << u.m_rchar
+               << "\" wchar=\"" << u.m_wchar
+               << "\" read_bytes=\"" << u.m_read_bytes
+               << "\" write_bytes=\"" << u.m_write_bytes
+               << "\" mapped=\"" << tc.m_mapped;
+
+            if( tc.m_runs > 1 )
+            {
+               Stats st = tc.stats();
+               of << "\" runs=\"" << tc.m_runs
+                  << "\" runs_ok=\"" << tc.m_runs_OK
+                  << "\" flaky=\"" << boolalpha << tc.flaky()
+                  << "\" median=\"" << st.m_median
+                  << "\" p95=\"" << st.m_p95
+                  << "\" stddev=\"" << st.m_stddev;
             }
+            of << "\">\n";
 
-            oss << "  <tr>\n";
-            oss << "    <td style=\"text-align:left;\" class=\"tablecell_"
-                << isError(tc.second.m_ts_FAIL) << "\">";
+            if( tc.m_runs > 1 )
+            {
+               of << "   <samples>";
+               for( auto t : tc.m_samples )
+               {
+                  of << t << " ";
+               }
+               of << "</samples>\n";
+            }
+
+            if( tc.m_cold_samples.size() > 0 )
+            {
+               of << "   <cold_samples>";
+               for( auto t : tc.m_cold_samples )
+               {
+                  of << t << " ";
+               }
+               of << "</cold_samples>\n";
+            }
+
+            for( size_t n = 0; n < m_perf_names.size() && n < tc.m_perf.size(); ++n )
+            {
+               of << "   <perf name=\"" << xmlEscape(m_perf_names[n])
+                  << "\" value=\"" << tc.m_perf[n]
+                  << (n < tc.m_cold_perf.size() ? "\" cold=\"" + to_string(tc.m_cold_perf[n]) : string(""))
+                  << "\"/>\n";
+            }
+
+            for( auto & ts : tc.m_tstep )
+            {
+               if( !ts.second.m_OK or m_ts_all )
+               {
+                  of << "   <step name=\"" << ts.first
+                     << "\" ok=\"" << boolalpha << ts.second.m_OK
+                     << "\" time=\"" << ts.second.m_time
+                     << "\" expr=\"" << xmlEscape(ts.second.m_step)
+                     << "\" msg=\"" << xmlEscape(ts.second.m_msg)
+                     << "\" expected=\"" << xmlEscape(ts.second.m_EX_expected.size() > 0 ?
+                                                     ts.second.m_EX_expected : ts.second.m_expect)
+                     << "\" actual=\"" << xmlEscape(ts.second.m_EX_happened.size() > 0 ?
+                                                   ts.second.m_EX_happened : ts.second.m_actual)
+                     << "\" what=\"" << xmlEscape(ts.second.m_what);
+                  if( ts.second.m_backtrace.size() > 0 )
+                  {
+                     string bt = ts.second.m_backtrace;
+                     replace(bt.begin(), bt.end(), '\n', ';');
+                     of << "\" backtrace=\"" << xmlEscape(bt);
+                  }
+                  of << "\"/>\n";
+               }
+            }
+
+            of << "  </testcase>\n";
+         }
+
+         of << " </suite>\n";
+      }
+
+      of << "</results>\n";
+
+      cout << "<tmp/results.xml> generated." << endl;
+   }
+
+   void Manager::genPDF()
+   {
+      if( !m_PDF )
+      {
+         return;
+      }
+
+      TraceSpan span("genPDF");
+
+      string path;
+
+      int fd[2];
+      if(pipe(fd) < 0)           /*create pipe */
+      {
+         throw runtime_error("no pipe");
+      }
+
+      ::mkdir("tmp", 0774);
+
+      switch( fork() )
+      {
+         case -1:
+            throw runtime_error("can not fork.");
+         case 0: // child
+            close(fd[0]);
+            dup2(fd[1], fileno(stdout));
+            execlp( "which", "which", "wkhtml2pdf", (char *)0 );
+            close(fd[0]);
+            exit(0);
+      }
+
+      close( fd[1] );
+      char line[200];
+      int n = read(fd[0], line, 199);
+      line[n] = (char)0;
+      close(fd[0]);
+      path = string(line);
+
+      if( path.size() == 0)
+      {
+         cout << "INFO: wkhtml2pdf not found, can't generate pdf file!\n"
+              << "  check http://code.google.com/p/wkhtmltopdf/" << endl;
+      } else {
+         const string cmd = "wkhtml2pdf -b --zoom 0.7 -s Letter tmp/results.html tmp/results.pdf";
+         system(cmd.c_str());
+         cout << "<tmp/results.pdf> created." << endl;
+      }
+
+   }
+
+   // comparing two results.xml (--compare), e.g. of ut_gcc and ut_clang ---------
+
+   struct Result
+   {
+         string m_status = "";
+         double m_time = 0.0;        // median with --repeat
+         set<string> m_failed {};    // names of the failed steps
+         vector<double> m_samples {}; // the times of all runs (--repeat)
+   };
+
+   string xmlAttr( const string & line, const string & name )
+   {
+      const string key = " " + name + "=\"";
+      auto pos = line.find(key);
+      if( pos == string::npos )
+      {
+         return "";
+      }
+      pos += key.size();
+
+      string val = line.substr(pos, line.find('"', pos) - pos);
+
+      const char * const ent[][2] = { { "&lt;", "<" }, { "&gt;", ">" }, { "&quot;", "\"" }, { "&amp;", "&" } };
+      for( auto & e : ent )
+      {
+         for( auto p = val.find(e[0]); p != string::npos; p = val.find(e[0], p + 1) )
+         {
+            val.replace(p, strlen(e[0]), e[1]);
+         }
+      }
+      return val;
+   }
+
+   map<string, Result> readResults( const string & file )
+   {
+      ifstream in(file);
+      if( !in )
+      {
+         throw runtime_error("can't read <" + file + ">");
+      }
+
+      map<string, Result> results;
+      Result * last = nullptr;
+      string line;
+
+      while( getline(in, line) )
+      {
+         if( line.find("<testcase ") != string::npos )
+         {
+            Result & r = results[xmlAttr(line, "tpath")];
+            r.m_status = xmlAttr(line, "status");
+            const string median = xmlAttr(line, "median");
+            r.m_time = stod(median.size() > 0 ? median : xmlAttr(line, "time"));
+            last = &r;
+         } else if( last != nullptr && line.find("<step ") != string::npos && xmlAttr(line, "ok") == "false" ) {
+            last->m_failed.insert(xmlAttr(line, "name"));
+         } else if( last != nullptr && line.find("<samples>") != string::npos ) {
+            istringstream in(line.substr(line.find('>') + 1));
+            double t;
+            while( in >> t )
+            {
+               last->m_samples.push_back(t);
+            }
+         }
+      }
+
+      return results;
+   }
+
+   // the <host .../> line of a results.xml, "" if it has none
+   string readHost( const string & file )
+   {
+      ifstream in(file);
+      string line;
+      while( getline(in, line) )
+      {
+         if( line.find("<host ") != string::npos )
+         {
+            return line;
+         }
+      }
+      return "";
+   }
+
+   // printTime() without html entities
+   string textTime( double t )
+   {
+      string str = printTime(t);
+      auto pos = str.find("&micro;");
+      if( pos != string::npos )
+      {
+         str.replace(pos, 7, "u");
+      }
+      return str;
+   }
+
+   // name of the run: "diff/gcc/tmp/results.xml" => "gcc"
+   string resultLabel( const string & file )
+   {
+      string label = file;
+      const string tail = "tmp/results.xml";
+      if( label.size() > tail.size() && label.compare(label.size() - tail.size(), tail.size(), tail) == 0 )
+      {
+         label.erase(label.size() - tail.size());
+      }
+      while( label.size() > 1 && label.back() == '/' )
+      {
+         label.pop_back();
+      }
+      const auto pos = label.rfind('/');
+      return pos == string::npos ? label : label.substr(pos + 1);
+   }
 
-            if( tc.second.m_ts_FAIL > 0 )
-            {
-               oss << "<a href=\"#" << s.second.m_name << "_" << tc.second.m_name << "\">";
-            }
+   // text table on stdout, html in tmp/compare.html; 1 if an outcome differs
+   int compare( const string & fileA, const string & fileB )
+   {
+      const auto resA = readResults(fileA);
+      const auto resB = readResults(fileB);
+      const string la = resultLabel(fileA);
+      const string lb = resultLabel(fileB);
+
+      set<string> tpaths;
+      for( auto & r : resA ) tpaths.insert(r.first);
+      for( auto & r : resB ) tpaths.insert(r.first);
+
+      ostringstream html;
+      int differ = 0;
+      int fasterA = 0;
+      int fasterB = 0;
+      double logSum = 0.0;
+      int timed = 0;
+
+      cout << left << setw(40) << "testcase" << " " << setw(9) << la << " " << setw(9) << lb << " "
+           << right << setw(12) << la << " " << setw(12) << lb << "  faster" << endl;
+
+      for( auto & t : tpaths )
+      {
+         const auto a = resA.find(t);
+         const auto b = resB.find(t);
 
-            oss << tc.second.m_name;
+         const Result ra = a != resA.end() ? a->second : Result();
+         const Result rb = b != resB.end() ? b->second : Result();
+         const string sa = ra.m_status.empty() ? "MISSING" : ra.m_status;
+         const string sb = rb.m_status.empty() ? "MISSING" : rb.m_status;
 
-            if( tc.second.m_ts_FAIL > 0 )
-            {
-               oss << "</a>";
-            }
+         // same status but different failed steps is a different outcome as well
+         const bool same = sa == sb && ra.m_failed == rb.m_failed;
+         differ += !same;
 
-            oss << "</td>\n";
+         if( same && sa == "DISABLED" )
+         {
+            continue;
+         }
 
-            oss << "    <td style=\"text-align:left;\" class=\"tablecell_" << isError(tc.second.m_ts_FAIL)
-                << "\">" << p->second.m_desc << "</td>\n";
+         string faster = "";
+         if( ra.m_time > 0 && rb.m_time > 0 && sa != "DISABLED" && sb != "DISABLED" )
+         {
+            const double ratio = rb.m_time / ra.m_time;
+            logSum += log(ratio);
+            timed++;
 
-            oss << "    <td class=\"tablecell_" << isError(tc.second.m_ts_FAIL) << "\">"
-                << tc.second.m_ts_OK + tc.second.m_ts_FAIL << "</td>\n";
+            // below 5% it is noise
+            ostringstream oss;
+            oss << fixed << setprecision(2);
+            if( ratio > 1.05 )
+            {
+               oss << la << " " << ratio << "x";
+               fasterA++;
+            } else if( ratio < 1 / 1.05 ) {
+               oss << lb << " " << 1 / ratio << "x";
+               fasterB++;
+            } else {
+               oss << "~";
+            }
+            faster = oss.str();
+         }
 
-            oss << "    <td class=\"tablecell_" << isError(tc.second.m_ts_FAIL) << "\">" << tc.second.m_ts_OK << "</td>\n";
+         cout << left << setw(40) << t << " " << setw(9) << sa << " " << setw(9) << sb << " "
+              << right << setw(12) << (ra.m_time > 0 ? textTime(ra.m_time) : "") << " "
+              << setw(12) << (rb.m_time > 0 ? textTime(rb.m_time) : "") << "  " << faster
+              << (same ? "" : "  <== DIFFERENT OUTCOME") << endl;
+
+         const string cls = same ? "tablecell_success" : "tablecell_error";
+         html << "  <tr>\n"
+              << "    <td class=\"" << (same ? "tablecell_left" : "tablecell_lefterror") << "\">" << xmlEscape(t) << "</td>\n"
+              << "    <td class=\"" << cls << "\">" << sa << "</td>\n"
+              << "    <td class=\"" << cls << "\">" << sb << "</td>\n"
+              << "    <td class=\"tablecell_success\">" << (ra.m_time > 0 ? printTime(ra.m_time) : "") << "</td>\n"
+              << "    <td class=\"tablecell_success\">" << (rb.m_time > 0 ? printTime(rb.m_time) : "") << "</td>\n"
+              << "    <td class=\"tablecell_success\">" << faster << "</td>\n"
+              << "  </tr>\n";
+      }
 
-            oss << "    <td class=\"tablecell_" << isError(tc.second.m_ts_FAIL) << "\">"
-                << setprecision(3) << tc.second.m_ts_OK * 100.0 / (tc.second.m_ts_OK + tc.second.m_ts_FAIL) << "</td>\n";
+      ostringstream sum;
+      sum << tpaths.size() << " testcases, " << differ << " with different outcome; "
+          << la << " faster in " << fasterA << ", " << lb << " faster in " << fasterB;
+      if( timed > 0 )
+      {
+         sum << "; geometric mean " << lb << "/" << la << ": " << fixed << setprecision(3) << exp(logSum / timed);
+      }
 
-            oss << "    <td class=\"tablecell_" << isError(tc.second.m_ts_FAIL) << "\">" << tc.second.m_ts_FAIL << "</td>\n";
+      cout << "\n" << sum.str() << endl;
 
-            oss << "    <td class=\"tablecell_" << isError(tc.second.m_ts_FAIL) << "\">"
-                << setprecision(3) << tc.second.m_ts_FAIL * 100.0 / (tc.second.m_ts_OK + tc.second.m_ts_FAIL) << "</td>\n";
+      ::mkdir("tmp", 0774);
+      ofstream of("tmp/compare.html");
 
-            oss << "    <td class=\"tablecell_" << isError(tc.second.m_ts_FAIL) << "\">"
-                << printTime( tc.second.m_time ) << "</td>\n" << "  </tr>\n";
+      for( auto & i : s_html )
+      {
+         string line(i);
+         auto pos = line.find("$TITLE$");
+         if( pos != string::npos )
+         {
+            line.replace(pos, 7, la + " vs. " + lb);
          }
-         oss << "</table>\n";
+         of << line << "\n";
 
-         if( disabled )
+         if( line == "<body>" )
          {
-            oss << "  <br />\n<table>\n"
-                << "  <tr>\n  <td style=\"text-align:left;\" class=\"tablecell_warn\"> test cases marked yellow were DISABLED !</td>\n</tr>\n</table>\n";
+            break;
          }
-         oss << "<p class=\"spaced\"><a href=\"#top\">Back to top</a></p>\n";
       }
 
-      line.replace(pos, 8, oss.str());
+      of << "<h1>" << xmlEscape(la) << " vs. " << xmlEscape(lb) << "</h1>\n"
+         << "<p>" << xmlEscape(fileA) << " / " << xmlEscape(fileB) << "</p>\n"
+         << "<p>" << xmlEscape(sum.str()) << "</p>\n<hr />\n"
+         << "<table style=\"table-layout: fixed;\" summary=\"comparison\" class=\"table_suite\">\n"
+         << " <col width=\"300px\" />\n"
+         << "  <tr>\n"
+         << "    <td style=\"text-align: left;\" class=\"tablecell_title\">Testcase</td>\n"
+         << "    <td class=\"tablecell_title\">" << xmlEscape(la) << "</td>\n"
+         << "    <td class=\"tablecell_title\">" << xmlEscape(lb) << "</td>\n"
+         << "    <td class=\"tablecell_title\">Time " << xmlEscape(la) << "</td>\n"
+         << "    <td class=\"tablecell_title\">Time " << xmlEscape(lb) << "</td>\n"
+         << "    <td class=\"tablecell_title\">faster</td>\n"
+         << "  </tr>\n"
+         << html.str()
+         << "</table>\n</body>\n</html>\n";
+
+      cout << "<tmp/compare.html> generated." << endl;
+
+      return differ > 0 ? 1 : 0;
    }
 
-   void Manager::genSummary(const string::size_type pos, string & line)
-   {
-      string insHtml;
-      insHtml.reserve(2000);
-
-      int tc_OK = 0;
-      int tc_FAIL = 0;
-      int tc_DISABLE = 0;
+   // --bench-compare ----------------------------------------------------
 
-      for( auto & i : m_suites )
+   // two sided p-value of the Mann-Whitney U test for samples a and b;
+   // exact for small samples without ties, else the normal approximation
+   double mannWhitney( const vector<double> & a, const vector<double> & b )
+   {
+      const size_t n = a.size();
+      const size_t m = b.size();
+
+      // ranks of the pooled samples, ties get the mean rank
+      vector< pair<double, int> > all;
+      for( auto x : a ) all.push_back(make_pair(x, 0));
+      for( auto x : b ) all.push_back(make_pair(x, 1));
+      sort(all.begin(), all.end());
+
+      double rankA = 0.0;
+      double tieSum = 0.0;   // sum of t^3 - t
+      for( size_t i = 0; i < all.size(); )
       {
-         tc_OK += i.second.m_tc_OK;
-         tc_FAIL += i.second.m_tc_FAIL;
-         tc_DISABLE += i.second.m_tc_DISABLED;
+         size_t j = i;
+         while( j < all.size() && all[j].first == all[i].first ) j++;
+         const double rank = (i + 1 + j) / 2.0;
+         for( size_t k = i; k < j; ++k )
+         {
+            if( all[k].second == 0 ) rankA += rank;
+         }
+         const double t = j - i;
+         tieSum += t * t * t - t;
+         i = j;
       }
 
-      // handle OK/FAIL
-      if( tc_FAIL > 0 )
-      {
-         ostringstream oss;
-         double percent = tc_FAIL * 100 / m_fmap.size();
-         oss << "<h3 style=\"color: red; background-color: yellow;\">FAILED testcases: "
-             << tc_FAIL << " (" << setprecision(3) << percent << "%)</h3>";
+      const double u = rankA - n * (n + 1) / 2.0;
+      const double mu = n * m / 2.0;
 
-         insHtml = oss.str();
+      if( n <= 20 && m <= 20 && tieSum == 0.0 )
+      {
+         // f[i][j][k]: arrangements of i a's and j b's with U = k
+         const size_t nm = n * m;
+         vector< vector< vector<double> > > f(n + 1, vector< vector<double> >(m + 1));
+         for( size_t i = 0; i <= n; ++i )
+         {
+            for( size_t j = 0; j <= m; ++j )
+            {
+               f[i][j].assign(i * j + 1, 0.0);
+               if( i == 0 || j == 0 )
+               {
+                  f[i][j][0] = 1.0;
+                  continue;
+               }
+               // the largest value is an a (counts j b's below it) or a b
+               for( size_t k = 0; k <= i * j; ++k )
+               {
+                  f[i][j][k] = (k >= j && k - j <= (i - 1) * j ? f[i - 1][j][k - j] : 0.0) +
+                               (k <= i * (j - 1) ? f[i][j - 1][k] : 0.0);
+               }
+            }
+         }
 
-      } else {
-         ostringstream oss;
+         double total = 0.0;
+         for( auto c : f[n][m] ) total += c;
 
-         oss << "<h3 style=\"color: green;\">OK testcases: " << tc_OK << " (100%)</h3>";
-         insHtml = oss.str();
+         // the tail on the side of u, doubled
+         const size_t lo = static_cast<size_t>(min(u, nm - u));
+         double tail = 0.0;
+         for( size_t k = 0; k <= lo; ++k ) tail += f[n][m][k];
+         return min(1.0, 2.0 * tail / total);
       }
 
-      // handle disabled testcases
-      if( tc_DISABLE > 0 )
+      const double N = n + m;
+      const double sigma = sqrt(n * m / 12.0 * ((N + 1) - tieSum / (N * (N - 1))));
+      if( sigma == 0.0 )
       {
-         ostringstream oss;
-         double percent = tc_DISABLE * 100 / m_fmap.size();
-         oss << "<h3 style=\"color: black; background-color: yellow;\">DISABLED testcases: "
-             << tc_DISABLE << " (" << setprecision(3) << percent << "%)</h3>";
-
-         insHtml += oss.str();
-
-      } else {
-         insHtml += "<h3 style=\"color: green;\">EXEC'd: 100%</h3>";
+         return 1.0;
       }
-
-      line.replace(pos,9, insHtml);
-   }
-
-   string Manager::isWarn( int i )
-   {
-      if( i > 0 ) return "warn";
-      return "success";
+      const double z = (fabs(u - mu) - 0.5) / sigma;   // continuity correction
+      return min(1.0, erfc(max(0.0, z) / sqrt(2.0)));
    }
 
-   string Manager::isWarn( bool b )
-   {
-      if( b ) return "warn";
-      return "success";
-   }
-
-   string Manager::isError( int i )
-   {
-      if( i > 0 ) return "error";
-      return "success";
-   }
-
-   string Manager::isError( bool b )
+   // Hodges-Lehmann estimate of the shift b/a and its 95% confidence
+   // interval: from the pairwise ratios b[j]/a[i] (the logs of them)
+   void shiftRatio( const vector<double> & a, const vector<double> & b,
+                    double & est, double & lo, double & hi )
    {
-      if( b ) return "error";
-      return "success";
+      vector<double> d;
+      d.reserve(a.size() * b.size());
+      for( auto x : a )
+      {
+         for( auto y : b )
+         {
+            d.push_back(log(y) - log(x));
+         }
+      }
+      sort(d.begin(), d.end());
+
+      const double n = a.size();
+      const double m = b.size();
+      const size_t nm = d.size();
+      est = exp(nm % 2 ? d[nm / 2] : (d[nm / 2 - 1] + d[nm / 2]) / 2.0);
+
+      // the order statistics the U distribution puts 2.5% beyond
+      const double k = floor(n * m / 2.0 - 1.96 * sqrt(n * m * (n + m + 1) / 12.0));
+      const size_t kk = static_cast<size_t>(max(0.0, k));
+      lo = exp(d[min(kk, nm - 1)]);
+      hi = exp(d[nm - 1 - min(kk, nm - 1)]);
    }
 
-   string Manager::sumLine( const string & lab, // label
-                            int a,     // total
-                            int b,     // exec'd
-                            int c,     // OK
-                            float d,   // OK %
-                            int e,     // FAIL
-                            float f,   // FAIL %
-                            int g,     // DISABLED
-                            float h    // DISABLED %
-                            )
+   // benchmark A/B: base and candidate results.xml, both with --repeat; per testcase the
+   // change (Hodges-Lehmann estimate), its 95% CI and the Mann-Whitney p-value. A change is significant
+   // if p < alpha and the CI excludes changes below threshold; 1 if a significant regression
+   int benchCompare( const string & fileA, const string & fileB, double alpha, double threshold )
    {
-      ostringstream oss;
-
-      // first cell (label)
-      oss << "  <tr>\n" << "    <td style=\"text-align: left;\" class=\"tablecell_";
-      if( e > 0 )
-      {
-         oss << "error";
-      }  else if (g > 0)
+      const auto resA = readResults(fileA);
+      const auto resB = readResults(fileB);
+      const string la = resultLabel(fileA);
+      const string lb = resultLabel(fileB);
+
+      // both should have run under the same conditions
+      const string hostA = readHost(fileA);
+      const string hostB = readHost(fileB);
+      for( auto attr : { "name", "cpu", "pinned", "governor", "nice" } )
       {
-         oss << "warn";
-      } else {
-         oss << "success";
+         if( xmlAttr(hostA, attr) != xmlAttr(hostB, attr) )
+         {
+            cout << "WARNING: " << attr << " differs: <" << xmlAttr(hostA, attr) << "> (" << la
+                 << ") vs. <" << xmlAttr(hostB, attr) << "> (" << lb << ")" << endl;
+         }
       }
 
-      oss << "\">" << lab << "</td>\n";
+      ostringstream html;
+      int regressions = 0;
+      int improvements = 0;
+      int compared = 0;
 
-      // 2. cell (total)
-      if( a < 0 )
+      cout << left << setw(40) << "benchmark" << right << setw(4) << "n" << setw(12) << la << setw(12) << lb
+           << setw(10) << "change" << setw(22) << "95% CI" << setw(10) << "p" << "  verdict" << endl;
+
+      for( auto & a : resA )
       {
-         oss << "    <td class=\"tablecell_success";
-         oss << "\"> " << "</td>\n";
-      } else {
-         oss << "    <td class=\"tablecell_success";
-         oss << "\">" << a << "</td>\n";
-      }
+         const auto b = resB.find(a.first);
+         if( b == resB.end() || a.second.m_samples.size() < 2 || b->second.m_samples.size() < 2 )
+         {
+            continue;   // not a benchmark in both runs
+         }
 
-      // 3. cell (exec'd)
-      oss << "    <td class=\"tablecell_" << isWarn( b<a )
-          << "\">" << b << "</td>\n";
+         const auto & sa = a.second.m_samples;
+         const auto & sb = b->second.m_samples;
+         const double medA = Stats::of(sa).m_median;
+         const double medB = Stats::of(sb).m_median;
+         if( medA <= 0.0 || medB <= 0.0 )
+         {
+            continue;
+         }
 
-      // 4. cell # OK
-      oss << "    <td class=\"tablecell_success"
-          << "\">" << c << "</td>\n";
+         compared++;
+         // the estimate its CI belongs to, not the ratio of the medians
+         double est, lo, hi;
+         shiftRatio(sa, sb, est, lo, hi);
+         const double change = est - 1.0;
+         const double p = mannWhitney(sa, sb);
 
-      // 5. cell % OK
-      oss << "    <td class=\"tablecell_success"
-          << "\">" << setprecision(3) << d << "</td>\n";
+         string verdict = "";
+         string cls = "tablecell_success";
+         if( p < alpha && lo - 1.0 > threshold )
+         {
+            verdict = "REGRESSION";
+            cls = "tablecell_error";
+            regressions++;
+         } else if( p < alpha && 1.0 - hi > threshold ) {
+            verdict = "improvement";
+            improvements++;
+         }
 
-      // 6. cell # DISABLED
-      if( g < 0 )
-      {
-         oss << "    <td class=\"tablecell_success"
-             << "\"> " << "</td>\n";
-      } else {
-         oss << "    <td class=\"tablecell_" << isWarn(g)
-             << "\">" << g << "</td>\n";
+         ostringstream ci;
+         ci << fixed << setprecision(1) << showpos << "[" << (lo - 1.0) * 100 << "%, " << (hi - 1.0) * 100 << "%]";
+         ostringstream ch;
+         ch << fixed << setprecision(1) << showpos << change * 100 << "%";
+         ostringstream pv;
+         pv << setprecision(2) << p;
+
+         cout << left << setw(40) << a.first << right << setw(4) << min(sa.size(), sb.size())
+              << setw(12) << textTime(medA) << setw(12) << textTime(medB)
+              << setw(10) << ch.str() << setw(22) << ci.str() << setw(10) << pv.str()
+              << (verdict.empty() ? "" : "  ") << verdict << endl;
+
+         html << "  <tr>\n"
+              << "    <td class=\"" << (verdict == "REGRESSION" ? "tablecell_lefterror" : "tablecell_left") << "\">"
+              << xmlEscape(a.first) << "</td>\n"
+              << "    <td class=\"" << cls << "\">" << sa.size() << " / " << sb.size() << "</td>\n"
+              << "    <td class=\"" << cls << "\">" << printTime(medA) << "</td>\n"
+              << "    <td class=\"" << cls << "\">" << printTime(medB) << "</td>\n"
+              << "    <td class=\"" << cls << "\">" << ch.str() << "</td>\n"
+              << "    <td class=\"" << cls << "\">" << ci.str() << "</td>\n"
+              << "    <td class=\"" << cls << "\">" << pv.str() << "</td>\n"
+              << "    <td class=\"" << cls << "\"><b>" << verdict << "</b></td>\n"
+              << "  </tr>\n";
       }
 
-      // 7. cell % DISABLED
-      if( g < 0 )
+      ostringstream sum;
+      sum << compared << " benchmarks (testcases with samples in both), " << regressions << " significant regression(s), "
+          << improvements << " improvement(s); alpha " << alpha << ", threshold " << threshold * 100 << "%";
+      cout << "\n" << sum.str() << endl;
+      if( compared == 0 )
       {
-         oss << "    <td class=\"tablecell_success"
-             << "\"> " << "</td>\n";
-      } else {
-         oss << "    <td class=\"tablecell_" << isWarn(g)
-             << "\">" << setprecision(3) << h << "</td>\n";
+         cout << "INFO: no samples, run both with --repeat <n> (n >= 2, better 20 or more)" << endl;
       }
 
-      // 8. cell # FAIL
-      oss << "    <td class=\"tablecell_" << isError(e)
-          << "\">" << e << "</td>\n";
+      ::mkdir("tmp", 0774);
+      ofstream of("tmp/bench.html");
 
-      // 9. cell % FAIL
-      oss << "    <td class=\"tablecell_" << isError(e)
-          << "\">" << setprecision(3) << f << "</td>\n";
+      for( auto & i : s_html )
+      {
+         string line(i);
+         auto pos = line.find("$TITLE$");
+         if( pos != string::npos )
+         {
+            line.replace(pos, 7, la + " vs. " + lb);
+         }
+         of << line << "\n";
 
-      oss << "  </tr>\n";
+         if( line == "<body>" )
+         {
+            break;
+         }
+      }
 
-      return oss.str();
+      of << "<h1>" << xmlEscape(la) << " vs. " << xmlEscape(lb) << " (benchmarks)</h1>\n"
+         << "<p>" << xmlEscape(fileA) << " / " << xmlEscape(fileB) << "</p>\n"
+         << "<p>" << xmlEscape(sum.str()) << "</p>\n<hr />\n"
+         << "<table style=\"table-layout: fixed;\" summary=\"benchmark comparison\" class=\"table_suite\">\n"
+         << " <col width=\"300px\" />\n"
+         << "  <tr>\n"
+         << "    <td style=\"text-align: left;\" class=\"tablecell_title\">Benchmark</td>\n"
+         << "    <td class=\"tablecell_title\">Runs</td>\n"
+         << "    <td class=\"tablecell_title\">Median " << xmlEscape(la) << "</td>\n"
+         << "    <td class=\"tablecell_title\">Median " << xmlEscape(lb) << "</td>\n"
+         << "    <td class=\"tablecell_title\">Change</td>\n"
+         << "    <td class=\"tablecell_title\">95% CI</td>\n"
+         << "    <td class=\"tablecell_title\">p (Mann-Whitney)</td>\n"
+         << "    <td class=\"tablecell_title\"></td>\n"
+         << "  </tr>\n"
+         << html.str()
+         << "</table>\n</body>\n</html>\n";
+
+      cout << "<tmp/bench.html> generated." << endl;
+
+      return regressions > 0 ? 1 : 0;
    }
 
-   void Manager::genSummary2(const string::size_type pos, string & line)
+   void usage()
    {
-      string insHtml;
-      insHtml.reserve(2000);
+      cout << "------ CPP11UT:\n";
+      cout << "-d            : enable debug output\n";
+      cout << "-a            : details of all test steps, not just the failed ones\n";
+      cout << "-f <filter>   : disable all testcases that do NOT contain <filter>\n";
+      cout << "-nopdf        : no pdf generation\n";
+      cout << "--perf        : count cycles, instructions, cache and branch misses per testcase\n";
+      cout << "--repeat <n>  : run the testcases n times, report flaky ones and time statistics\n";
+      cout << "--retries <n> : run a failed testcase again, up to n times (with -j in parallel); FLAKY if one passes\n";
+      cout << "--quarantine <file> : testcases (or paths) listed there run, but don't count for the verdict\n";
+      cout << "--until-fail  : repeat until a testcase fails (at most --repeat <n> times)\n";
+      cout << "-j <n>        : run testcases in n parallel threads\n";
+      cout << "--catch-signals : a crash (SIGSEGV, SIGFPE, SIGABRT, ...) fails the testcase, the run goes on\n";
+      cout << "--async-timeout <s> : an ASYNC_TEST not done by then fails (default 10)\n";
+      cout << "--capture     : what a testcase prints goes to the report (if it failed, -a: always)\n";
+      cout << "--cpus <list> : pin the threads to these cpus (e.g. 2,4-7): main/worker j on the j-th\n";
+      cout << "--priority <nice> : run with this nice value (< 0 needs CAP_SYS_NICE)\n";
+      cout << "--data <dir>  : root of the test data files (UT::testData), default $UT_DATA or data\n";
+      cout << "--update-snapshots : write the golden files of the snapshot assertions instead of comparing\n";
+      cout << "--trace       : write the run as trace events to tmp/trace.json (chrome://tracing, Perfetto)\n";
+      cout << "--time-budget <s> : most valuable testcases first, none is started that would end after <s> seconds\n";
+      cout << "--history <file>  : outcomes and times of earlier runs for --time-budget (default tmp/history.txt)\n";
+      cout << "--cold        : run each testcase after evicting the caches, then warm; both times reported\n";
+      cout << "--drop-caches : --cold, and drop the page cache, too (root only)\n";
+      cout << "--fuzz        : generate inputs for the FUZZ_TESTs (-f selects), then run the tests\n";
+      cout << "--fuzz-time <s> : seconds per FUZZ_TEST (default 10)\n";
+      cout << "--fuzz-runs <n> : executions per FUZZ_TEST instead of --fuzz-time\n";
+      cout << "--corpus <dir>  : inputs and crashes of the FUZZ_TESTs (default corpus)\n";
+      cout << "--compare <a.xml> <b.xml> : compare outcome and time of two results.xml, no tests run\n";
+      cout << "--bench-compare <base.xml> <cand.xml> : benchmark A/B of two --repeat runs, 1 if a significant regression\n";
+      cout << "--alpha <p>   : significance level of --bench-compare (default 0.05)\n";
+      cout << "--threshold <%> : smaller changes are not significant (default 2)\n";
+      cout << "--resident <a.so> ... : load test modules, rerun a module when it changed (make resident)\n";
 
-      ostringstream oss;
+      cout << "-h            : show available parameters\n";
+      cout << "--help        : show available parameters\n";
+      cout << endl;
+   }
 
-      insHtml += sumLine("Test Suites",       // label in first column
-                         m_suites.size(),     // total number of test suites
-                         m_su_OK + m_su_FAIL, // test suites exec'd
-                         m_su_OK,             // test suites OK
-                         m_su_OK * 100.0 / (m_su_OK + m_su_FAIL), // percent
-                         m_su_FAIL,           // test suites failed
-                         m_su_FAIL * 100.0 / (m_su_OK + m_su_FAIL),
-                         -1,
-                         0.0 );
+   void setParas(const ArgVS & args)
+   {
+      Manager & mgr = S_Manager::getInstance();
 
-      {
-         int tc_OK = 0;
-         int tc_FAIL = 0;
-         int tc_DISABLE = 0;
+      auto p = args.getValue<bool>("-d");
+      if( p )
+         mgr.m_debug = true;
 
-         for( auto & i : m_suites )
-         {
-            tc_OK += i.second.m_tc_OK;
-            tc_FAIL += i.second.m_tc_FAIL;
-            tc_DISABLE += i.second.m_tc_DISABLED;
-         }
+      p = args.getValue<bool>("-a");
+      if( p )
+         mgr.m_ts_all = true;
 
-         insHtml += sumLine("Test Cases",     // label in first column
-                            m_fmap.size(),    // total number of test cases
-                            tc_OK + tc_FAIL,  // test cases exec'd
-                            tc_OK ,           // test cases OK
-                            tc_OK * 100.0 / (tc_OK + tc_FAIL), // percent
-                            tc_FAIL,          // test cases failed
-                            tc_FAIL * 100.0 / (tc_OK + tc_FAIL),
-                            tc_DISABLE,
-                            tc_DISABLE * 100.0 / m_fmap.size()
-                            );
+      p = args.getValue<bool>("-nopdf");
+      if( p )
+         mgr.m_PDF = false;
+
+      p = args.getValue<bool>("--perf");
+      if( p )
+         mgr.m_perf = true;
+
+      p = args.getValue<bool>("--until-fail");
+      if( p )
+      {
+         mgr.m_until_fail = true;
+         mgr.m_repeat = numeric_limits<int>::max();
       }
 
+      p = args.getValue<bool>("--repeat");
+      if( p )
       {
-         int ts_OK = 0;
-         int ts_FAIL = 0;
-
-         for( auto & s : m_suites )
+         mgr.m_repeat = args.getValue<int>("--repeat");
+         if( mgr.m_repeat < 1 )
          {
-            for( auto & tc : s.second.m_tcs )
-            {
-               ts_OK += tc.second.m_ts_OK;
-               ts_FAIL += tc.second.m_ts_FAIL;
-            }
+            throw runtime_error("--repeat needs a value >= 1");
          }
+      }
 
-         insHtml += sumLine("Test Steps",  // label in first column
-                            -1,                 // total number of test cases
-                            ts_OK + ts_FAIL,    // test cases exec'd
-                            ts_OK ,             // test cases OK
-                            ts_OK * 100.0 / ( ts_OK + ts_FAIL), // percent
-                            ts_FAIL, // test suites failed
-                            ts_FAIL * 100.0 / (ts_OK + ts_FAIL),
-                            -1,
-                            0.0 );
+      p = args.getValue<bool>("--catch-signals");
+      if( p )
+      {
+         mgr.m_signals = true;
+         installCrashHandler();
       }
 
+      p = args.getValue<bool>("--capture");
+      if( p )
+         mgr.m_capture = true;
+
+      p = args.getValue<bool>("--async-timeout");
+      if( p )
+         mgr.m_async_timeout = stod(args.getValue<string>("--async-timeout"));
+
+      p = args.getValue<bool>("--fuzz");
+      if( p )
+         mgr.m_fuzz = true;
+
+      p = args.getValue<bool>("--fuzz-time");
+      if( p )
+         mgr.m_fuzz_time = stod(args.getValue<string>("--fuzz-time"));
+
+      p = args.getValue<bool>("--fuzz-runs");
+      if( p )
+         mgr.m_fuzz_runs = stoll(args.getValue<string>("--fuzz-runs"));
+
+      p = args.getValue<bool>("--corpus");
+      if( p )
+         mgr.m_corpus = args.getValue<string>("--corpus");
+
+      auto res = find(args.m_args.begin(), args.m_args.end(), "--resident");
+      if( res != args.m_args.end() )
       {
-         double t = 0;
-         for( auto & s : m_suites )
+         for( ++res; res != args.m_args.end() && (*res)[0] != '-'; ++res )
          {
-            for( auto & tc : s.second.m_tcs )
-            {
-               t += tc.second.m_time;
-            }
+            mgr.m_modules.push_back(*res);
+         }
+         if( mgr.m_modules.empty() )
+         {
+            throw runtime_error("--resident needs at least one module");
          }
-
-         ostringstream oss;
-         oss << "</table>\n" << "<p>Total time elapsed: "
-             << printTime(t) << "</p>\n";
-
-         insHtml += oss.str();
       }
 
-      line.replace(pos,11, insHtml);
-   }
-
+      auto bench = find(args.m_args.begin(), args.m_args.end(), "--bench-compare");
+      if( bench != args.m_args.end() )
+      {
+         if( args.m_args.end() - bench < 3 )
+         {
+            throw runtime_error("--bench-compare needs two result files");
+         }
+         mgr.m_bench.assign(bench + 1, bench + 3);
+      }
 
-   void Manager::genSumSuites(const string::size_type pos, string & line)
-   {
-      string name;
+      p = args.getValue<bool>("--alpha");
+      if( p )
+         mgr.m_alpha = stod(args.getValue<string>("--alpha"));
 
-      ostringstream oss;
+      p = args.getValue<bool>("--threshold");
+      if( p )
+         mgr.m_threshold = stod(args.getValue<string>("--threshold")) / 100.0;
 
-      for( auto & i : m_suites )
+      auto cmp = find(args.m_args.begin(), args.m_args.end(), "--compare");
+      if( cmp != args.m_args.end() )
       {
-         oss << "  <tr>\n";
+         if( args.m_args.end() - cmp < 3 )
+         {
+            throw runtime_error("--compare needs two result files");
+         }
+         mgr.m_compare.assign(cmp + 1, cmp + 3);
+      }
 
-         oss << "    <td style=\"text-align:left;\" class=\"tablecell_" << isError(i.second.m_tc_FAIL) << "\"><a href=\"#"
-             << i.second.m_name << "\">" << i.second.m_name << "</a></td>\n";
+      p = args.getValue<bool>("-j");
+      if( p )
+      {
+         mgr.m_jobs = args.getValue<int>("-j");
+         if( mgr.m_jobs < 1 )
+         {
+            throw runtime_error("-j needs a value >= 1");
+         }
+      }
+ 
+      p = args.getValue<bool>("--data");
+      if( p )
+         mgr.m_data_root = args.getValue<string>("--data");
 
-         oss << "    <td class=\"tablecell_success\">"
-             <<  i.second.m_tc_OK + i.second.m_tc_FAIL + i.second.m_tc_DISABLED << "</td>\n";
+      p = args.getValue<bool>("--update-snapshots");
+      if( p )
+         mgr.m_update_snapshots = true;
 
-         oss << "    <td class=\"tablecell_" << isWarn( i.second.m_tc_DISABLED ) << "\">"
-             <<  i.second.m_tc_OK + i.second.m_tc_FAIL << "</td>\n";
+      p = args.getValue<bool>("--retries");
+      if( p )
+      {
+         mgr.m_retries = stoi(args.getValue<string>("--retries"));
+         if( mgr.m_retries < 0 )
+         {
+            throw runtime_error("--retries: n >= 0 expected");
+         }
+      }
 
-         oss << "    <td class=\"tablecell_success\">"
-             <<  i.second.m_tc_OK << "</td>\n";
+      p = args.getValue<bool>("--quarantine");
+      if( p )
+      {
+         const string file = args.getValue<string>("--quarantine");
+         ifstream in(file);
+         if( !in )
+         {
+            throw runtime_error("--quarantine: can't read <" + file + ">");
+         }
+         // one testcase or path per line, # starts a comment
+         string line;
+         while( getline(in, line) )
+         {
+            line = line.substr(0, line.find('#'));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            line.erase(0, line.find_first_not_of(" \t"));
+            if( line.size() > 0 )
+            {
+               mgr.m_quarantine.push_back(line);
+            }
+         }
+         cout << "INFO: " << mgr.m_quarantine.size() << " quarantined testcase(s)/path(s) from <" << file << ">" << endl;
+      }
 
-         oss << "    <td class=\"tablecell_success\">"
-             <<  setprecision(3);
-         if( i.second.m_tc_OK + i.second.m_tc_FAIL < 1 )
+      p = args.getValue<bool>("--time-budget");
+      if( p )
+      {
+         mgr.m_budget = stod(args.getValue<string>("--time-budget"));
+         if( mgr.m_budget <= 0 )
          {
-            oss << 0.0;
-         } else {
-            oss << i.second.m_tc_OK * 100.0 / ( i.second.m_tc_OK + i.second.m_tc_FAIL );
+            throw runtime_error("--time-budget: seconds > 0 expected");
          }
-         oss << "</td>\n";
+      }
 
-         oss << "    <td class=\"tablecell_" << isWarn( i.second.m_tc_DISABLED ) << "\">"
-             <<  i.second.m_tc_DISABLED << "</td>\n";
+      p = args.getValue<bool>("--history");
+      if( p )
+         mgr.m_history_file = args.getValue<string>("--history");
 
-         oss << "    <td class=\"tablecell_" << isWarn( i.second.m_tc_DISABLED ) << "\">"
-             <<  setprecision(3) << i.second.m_tc_DISABLED * 100.0 / ( i.second.m_tc_OK + i.second.m_tc_FAIL + i.second.m_tc_DISABLED ) << "</td>\n";
+      p = args.getValue<bool>("--trace");
+      if( p )
+      {
+         s_tracer.m_on = true;
+         s_tracer.m_process = args.m_args[0];
+      }
 
-         oss << "    <td class=\"tablecell_" << isError( i.second.m_tc_FAIL ) << "\">"
-             <<  i.second.m_tc_FAIL << "</td>\n";
+      p = args.getValue<bool>("--cold") || args.getValue<bool>("--drop-caches");
+      if( p )
+      {
+         mgr.m_cold = true;
+         s_evictor.m_drop_pages = args.getValue<bool>("--drop-caches");
+         s_evictor.init();
+         cout << "INFO: --cold: last level cache " << printBytes(s_evictor.m_llc)
+              << ", evicted with " << printBytes(s_evictor.m_size) << " before each cold run" << endl;
+         if( mgr.m_jobs > 1 )
+         {
+            cerr << "WARNING: --cold with -j " << mgr.m_jobs << ": an eviction cools the caches of"
+                 << " the other threads, too." << endl;
+         }
+      }
 
-         oss << "    <td class=\"tablecell_" << isError( i.second.m_tc_FAIL ) << "\">"
-             <<  setprecision(3);
+      p = args.getValue<bool>("--priority");
+      if( p )
+      {
+         const int nice = args.getValue<int>("--priority");
+         // per thread on Linux, the workers inherit it
+         if( setpriority(PRIO_PROCESS, 0, nice) != 0 )
+         {
+            cerr << "WARNING: setpriority(" << nice << ") failed (" << strerror(errno)
+                 << "), priority unchanged." << endl;
+         }
+      }
 
-         if(  i.second.m_tc_OK + i.second.m_tc_FAIL < 1 )
+      p = args.getValue<bool>("--cpus");
+      if( p )
+      {
+         mgr.m_cpus = parseCpuList(args.getValue<string>("--cpus"));
+         if( mgr.m_cpus.empty() )
          {
-            oss << 0.0;
-         } else {
-            oss << i.second.m_tc_FAIL * 100.0 / ( i.second.m_tc_OK + i.second.m_tc_FAIL );
+            throw runtime_error("--cpus needs a cpu list");
          }
-         oss << "</td>\n";
 
-         double t=0;
-         for( auto & tc : i.second.m_tcs )
+         cpu_set_t allowed;
+         sched_getaffinity(0, sizeof(allowed), &allowed);
+         for( auto c : mgr.m_cpus )
          {
-            t += tc.second.m_time;
+            if( !CPU_ISSET(c, &allowed) )
+            {
+               throw runtime_error("--cpus: cpu " + to_string(c) + " is offline or not allowed");
+            }
          }
+      }
+
+      p = args.getValue<bool>("-f");
+      if( p )
+      {
+         string filt = args.getValue<string>("-f");
+         mgr.setFilter(filt.c_str());
+         cout << "INFO: set filter to <" << filt << ">" << endl;
 
-         oss << "    <td class=\"tablecell_success\">"
-             << printTime(t) << "</td>\n" << "  </tr>\n";
       }
 
-      line.replace(pos, 12, oss.str());
+      p = args.getValue<bool>("-h") || args.getValue<bool>("--help") ;
+      if( p )
+      {
+         usage();
+         exit(0);
+      }
    }
 
-   void Manager::genGtime(const string::size_type pos, string & line)
+   void getArgs( const int argc, char const * const argv[] )
    {
-      ostringstream oss;
+      ArgVS args;
+      for( int i = 0; i< argc; ++i )
+      {
+         args.m_args.push_back(argv[i]);
+      }
 
-      time_t rawtime;
-      struct tm * timeinfo;
-      char buffer[200];
+      setParas(args);
+   } 
+}
 
-      time(&rawtime);
-      timeinfo = localtime(&rawtime);
-      strftime( buffer, 80, "%Y-%m-%d  %H:%M:%S  %Z", timeinfo);
+// === namespace UT =============================================================
+namespace UT {
 
-      oss << "<div style=\"border: 0px;font-size: 13px; font-family: monospace; text-align: center;\">generation time: "
-          << buffer << "</div>\n";
+   void step_passed(UT::Probe & probe);
+   void step_failed_values(UT::Probe & probe,
+                           const string & aVal,
+                           const string & bVal,
+                           const std::string & str_a,
+                           const std::string & str_b);
 
-      getcwd(buffer,200);
+   Probe::Probe(
+                const std::string & fname,          // file name where probe is located
+                const int lineNumber,               // __LINE__
+                const std::string & tpath,          // p1: tcase path; unique KEY
+                const std::string & desc,           // p2: description
+                std::function< void (void)> tfunc,  // p3: lambda test function
+                const std::string & group           // TEST_PARAM the probe is a row of
+                ) :
+      m_fname(fname),
+      m_line(lineNumber),
+      m_tpath(tpath),
+      m_desc(desc),
+      m_func(tfunc),
 
-      oss << "<div style=\"border: 0px;font-size: 13px; font-family: monospace; text-align: center;\">"
-          << buffer << "</div>\n";
+      m_suite(""),
+      m_tname(""),
+      m_disabled(false),
+      m_group(group)
+   {
+      convertNames(tpath, m_suite, m_tname, m_disabled);
+      S_Manager::getInstance().subscribe(*this);
+   }
 
-      line.replace(pos, 7, oss.str());
+   Probe::Probe(
+                const std::string & fname,          // file name where probe is located
+                const int lineNumber,               // __LINE__
+                const std::string & tpath,          // p1: tcase path; unique KEY
+                const std::string & desc,           // p2: description
+                const FuzzTarget & target           // p3: FUZZ_TEST target
+                ) :
+      m_fname(fname),
+      m_line(lineNumber),
+      m_tpath(tpath),
+      m_desc(desc),
+
+      m_suite(""),
+      m_tname(""),
+      m_disabled(false),
+      m_fuzz(make_shared<FuzzTarget>(target))
+   {
+      convertNames(tpath, m_suite, m_tname, m_disabled);
+      S_Manager::getInstance().subscribe(*this);
    }
 
-   void Manager::genTestResults(const string::size_type pos, string & line)
+   Probe::Probe(
+                const char * fname,                 // file name where probe is located
+                const int lineNumber,               // __LINE__
+                const char * tpath,                 // p1: tcase path; unique KEY
+                const char * desc,                  // p2: description
+                void (*tfunc)()                     // p3: EXEC lambda
+                ) :
+      Probe(string(fname), lineNumber, string(tpath), string(desc), function<void (void)>(tfunc))
    {
-      string insHtml;
-      insHtml.reserve(10000);
-      bool failFound = false;
+   }
 
-      string name;
-      ostringstream oss;
+   Probe::Probe(
+                const char * fname,                 // file name where probe is located
+                const int lineNumber,               // __LINE__
+                const char * tpath,                 // p1: tcase path; unique KEY
+                const char * desc,                  // p2: description
+                void (*tfunc)(Async &)              // p3: AEXEC lambda
+                ) :
+      m_fname(fname),
+      m_line(lineNumber),
+      m_tpath(tpath),
+      m_desc(desc),
 
-      for( auto & s : m_suites )
-      {
-         for( auto & tc : s.second.m_tcs )
-         {
-            if( tc.second.m_ts_FAIL > 0 or m_ts_all )
-            {
-               if( !failFound)
-               {
-                  oss << "<h2>Test result details - Test steps</h2>\n";
-                  failFound = true;
-               }
+      m_suite(""),
+      m_tname(""),
+      m_disabled(false),
+      m_async(tfunc)
+   {
+      convertNames(tpath, m_suite, m_tname, m_disabled);
+      S_Manager::getInstance().subscribe(*this);
+   }
+
+   Probe::Probe( const std::string & cmdString,   // cmd-string
+                 const std::string & data         // data
+                 )
+   {
+      if( cmdString == "setTitle" )
+      {
+         S_Manager::getInstance().setTitle(data);
+         return;
+      }
 
-               auto p = m_fmap.find(tc.second.m_tpath);
+      cerr << "ERROR: invalid cmd found: <" << cmdString << "> (ignored)." << endl;
+   }
 
-               for( auto & ts : tc.second.m_tstep )
-               {
-                  if( !ts.second.m_OK or m_ts_all )
-                  {
-                     oss << "<h3><a name=\"" << s.second.m_name << "_" << tc.second.m_name << "\">"
-                         << s.second.m_name << "::" << tc.second.m_name << "</a></h3>\n";
+   Async::Async( AsyncLoop & loop, Probe & probe ) :
+      m_loop(loop),
+      m_probe(probe)
+   {
+   }
 
-                     oss << "<table style=\"table-layout: fixed;\" summary=\"Test Failure\" class=\"table_result\">\n"
-                         << " <col width=\"100px\" />\n"
-                         << "<tr>\n" << "<td style=\"text-align:left;\" class=\"tablecell_title\">Testcase</td>\n"
-                         << "<td class=\"tablecell_left\">" <<  s.second.m_name << "::" << tc.second.m_name
-                         << "</td>\n</tr>\n";
+   void Async::on( int fd, uint32_t events, function<void (uint32_t)> f )
+   {
+      if( m_done )
+      {
+         return;
+      }
 
-                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Descript.</td>"
-                         << "    <td class=\"tablecell_left\">";
+      epoll_event ev;
+      memset(&ev, 0, sizeof(ev));
+      ev.events = events;
+      ev.data.fd = fd;
 
-                     //oss << p->second.m_desc <<  "</td>\n  </tr>";
-                     oss <<ts.second.m_desc <<  "</td>\n  </tr>";
+      const bool known = m_loop.m_watch.count(fd) > 0;
+      if( epoll_ctl(m_loop.m_epfd, known ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev) != 0 )
+      {
+         throw runtime_error("epoll_ctl(" + to_string(fd) + "): " + strerror(errno));
+      }
 
+      m_loop.m_watch[fd] = make_pair(this, move(f));
+      if( !known )
+      {
+         m_fds.push_back(fd);
+      }
+   }
 
-                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">File</td>"
-                         << "    <td class=\"tablecell_left\">";
-                     oss << p->second.m_fname << ":" << p->second.m_line << "</td>\n  </tr>\n";
+   void Async::off( int fd )
+   {
+      auto w = m_loop.m_watch.find(fd);
+      if( w == m_loop.m_watch.end() || w->second.first != this )
+      {
+         return;
+      }
 
+      epoll_ctl(m_loop.m_epfd, EPOLL_CTL_DEL, fd, nullptr);
+      m_loop.m_watch.erase(w);
+      m_fds.erase(remove(m_fds.begin(), m_fds.end(), fd), m_fds.end());
+   }
 
-                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Test Step</td>"
-                         << "    <td class=\"tablecell_left\">" << ts.first << "</td></tr>\n";
+   void Async::after( double seconds, function<void (void)> f )
+   {
+      if( m_done )
+      {
+         return;
+      }
 
-                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Status</td>"
-                         << "    <td class=\"tablecell_left";
-                     if( ts.second.m_OK )
-                     {
-                        oss << "\">OK.";
-                     } else {
-                        oss << "error\">FAILED.";
-                     }
-                     oss << "</td></tr>\n";
+      m_loop.m_timers.push_back(AsyncLoop::Timer{monotonic() + seconds, m_loop.m_seq++, this, move(f)});
+      push_heap(m_loop.m_timers.begin(), m_loop.m_timers.end(), greater<AsyncLoop::Timer>());
+   }
 
-                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Message</td>"
-                         << "    <td class=\"tablecell_left\">" << ts.second.m_msg <<  "</td>\n  </tr>";
+   void Async::timeout( double seconds )
+   {
+      m_deadline = monotonic() + seconds;
+      after(seconds, [this]()
+            {
+               // an earlier timeout() than the last one
+               if( monotonic() >= m_deadline )
+               {
+                  m_timedout = true;
+                  done();
+               }
+            });
+   }
 
-                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Expected</td>"
-                         << "    <td class=\"tablecell_left\">";
+   void Async::done()
+   {
+      if( m_done )
+      {
+         return;
+      }
 
-                     if( ts.second.m_EX_expected.size() > 0 )
-                     {
-                        oss << ts.second.m_EX_expected;
-                     } else {
-                        oss << ts.second.m_expect;
-                     }
-                     oss <<  "</td>\n  </tr>";
+      m_done = true;
+      m_end = monotonic();
+      m_loop.m_finished.push_back(this);
+   }
 
+   void Async::fail( exception_ptr e )
+   {
+      if( !m_done && !m_error )
+      {
+         m_error = e;
+      }
+      done();
+   }
 
-                     oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">Actual</td>"
-                         << "    <td class=\"tablecell_left\">";
+   VirtualClock::time_point VirtualClock::now()
+   {
+      return time_point(clockState().m_now);
+   }
 
-                     if( ts.second.m_EX_happened.size() > 0 )
-                     {
-                        oss << ts.second.m_EX_happened;
-                     } else {
-                        oss << ts.second.m_actual;
-                     }
-                     oss <<  "</td>\n  </tr>\n";
+   void VirtualClock::advance_to( const time_point & t )
+   {
+      ClockState & c = clockState();
+      const duration to = t.time_since_epoch();
 
-                     // what
-                     if( ts.second.m_what.size() > 0 )
-                     {
-                        oss << "<tr>\n<td style=\"text-align:left;\" class=\"tablecell_title\">What</td>"
-                            << "    <td class=\"tablecell_left\">";
+      // a timer may add timers, also ones before t
+      while( c.m_timers.size() > 0 && c.m_timers.begin()->first <= to )
+      {
+         auto first = c.m_timers.begin();
+         c.m_now = max(c.m_now, first->first);
+         auto f = move(first->second);
+         c.m_timers.erase(first);
+         f();
+      }
 
-                        oss << ts.second.m_what;
-                        oss <<  "</td>\n  </tr>\n";
-                     }
+      c.m_now = max(c.m_now, to);
+   }
 
-                     oss << "</table>\n";
-                     oss << "<p class=\"spaced\"><a href=\"#top\">Back to top</a></p>\n";
-                     oss << "<hr />\n";
-                  }
-               }
-               insHtml += oss.str();
-               oss.str("");
-               oss.clear();
-            }
-         }
-      }
+   void VirtualClock::at( const time_point & t, function<void (void)> f )
+   {
+      ClockState & c = clockState();
+      c.m_timers.insert(make_pair(t.time_since_epoch(), move(f)));
+   }
 
-      line.replace(pos, 13, insHtml);
+   size_t VirtualClock::pending()
+   {
+      return clockState().m_timers.size();
    }
 
-   void Manager::genHTML()
+   Depends::Depends( const char * tpath, const char * prerequisite )
    {
-      ::mkdir("tmp", 0774);
+      S_Manager::getInstance().depends(tpath, prerequisite);
+   }
 
-      ofstream of("tmp/results.html");
-      string::size_type pos;
+   Crashes::Crashes( const char * tpath )
+   {
+      S_Manager::getInstance().crashes(tpath);
+   }
 
-      for( auto & i : s_html )
-      {
-         string line(i);
-         pos = 10;
+   const DataFile & testData( const std::string & name, int flags )
+   {
+      return S_Manager::getInstance().testData(name, flags);
+   }
 
-         while( pos != string::npos)
+   // the streambuf of a Snapshot: every full buffer is hashed and compared with the
+   // golden file at the same offset; with --update-snapshots it goes to <golden>.new
+   struct SnapshotState : streambuf
+   {
+         SnapshotState( const SnapshotState & ) = delete;
+         SnapshotState & operator=( const SnapshotState & ) = delete;
+
+         SnapshotState( const string & name, Snapshot::Mode mode ) :
+            m_path(S_Manager::getInstance().dataPath(name)),
+            m_mode(mode)
          {
-            pos = line.find("$GTIME$");
-            if( pos != string::npos )
-            {
-               genGtime(pos, line);
-               continue;
-            }
+            ifstream digest(m_path + ".xxh64");
+            m_has_digest = bool(digest >> hex >> m_golden_digest >> dec >> m_golden_size);
 
-            pos = line.find("$TITLE$");
-            if( pos != string::npos )
+            if( access(m_path.c_str(), R_OK) == 0 )
             {
-               line.replace(pos, 7, m_title);
-               continue;
+               m_golden = &testData(name);
             }
 
-            pos = line.find("$SUMMARY$");
-            if( pos != string::npos )
+            if( S_Manager::getInstance().m_update_snapshots && mode == Snapshot::Bytes && (m_golden || !m_has_digest) )
             {
-               genSummary(pos, line);
-               continue;
+               for( auto pos = m_path.find('/', 1); pos != string::npos; pos = m_path.find('/', pos + 1) )
+               {
+                  ::mkdir(m_path.substr(0, pos).c_str(), 0775);
+               }
+               m_out.open(m_path + ".new", ios::binary | ios::trunc);
+               if( !m_out )
+               {
+                  throw runtime_error("snapshot: can't write <" + m_path + ".new>");
+               }
             }
 
-            pos = line.find("$SUMMARY-2$");
-            if( pos != string::npos )
-            {
-               genSummary2(pos, line);
-               continue;
-            }
+            setp(m_buf.data(), m_buf.data() + m_buf.size());
+         }
 
-            pos = line.find("$SUM-SUITES$");
-            if( pos != string::npos )
+         int overflow( int c ) override
+         {
+            sync();
+            if( c != traits_type::eof() )
             {
-               genSumSuites(pos, line);
-               continue;
+               *pptr() = traits_type::to_char_type(c);
+               pbump(1);
             }
+            return traits_type::not_eof(c);
+         }
 
-            pos = line.find("$SUITES$");
-            if( pos != string::npos )
-            {
-               genSuites(pos, line);
-               continue;
-            }
+         int sync() override
+         {
+            consume(pbase(), pptr() - pbase());
+            setp(m_buf.data(), m_buf.data() + m_buf.size());
+            return 0;
+         }
 
-            pos = line.find("$TESTRESULTS$");
-            if( pos != string::npos )
+         // large writes go through without a copy
+         streamsize xsputn( const char * p, streamsize n ) override
+         {
+            if( n < streamsize(m_buf.size()) )
             {
-               genTestResults(pos, line);
-               continue;
+               return streambuf::xsputn(p, n);
             }
+            sync();
+            consume(p, n);
+            return n;
+         }
 
-         };
-
-         of << line << "\n";
-      }
-      cout << "<tmp/results.html> generated." << endl;
-   }
-
-   void Manager::tc_disabled(const UT::Probe & probe)
-   {
-      cout << "INFO: Test " << probe.m_tpath
-           << " skipped because of filter condition <"
-           << m_filter << ">" << endl;
-
-      auto p = m_suites.find(probe.m_suite);
-      if( p == m_suites.end() )
-      {
-         throw runtime_error("Suite not found !");
-      }
-
-      Suite & suite = p->second;
-
-      auto p_tc = suite.m_tcs.find(probe.m_tname);
-      if( p_tc == suite.m_tcs.end() )
-      {
-         throw runtime_error("Testcase not found !");
-      }
+         void consume( const char * data, size_t n )
+         {
+            const unsigned char * p = reinterpret_cast<const unsigned char *>(data);
+            m_hash.update(p, n);
 
-      p_tc->second.m_disabled = true;
-   }
+            if( m_golden )
+            {
+               const unsigned char * g = m_golden->data() + min<size_t>(m_pos, m_golden->size());
+               const size_t common = m_pos < m_golden->size() ? min<size_t>(n, m_golden->size() - m_pos) : 0;
+               size_t i = m_diff_open ? 0 : common;   // a difference may go on from the last chunk
 
-   void Manager::exec()
-   {
-      string suite;
-      string what;
+               if( !m_differs && (memcmp(p, g, common) != 0 || common < n) )
+               {
+                  for( i = 0; i < common && p[i] == g[i]; ++i )
+                  {
+                  }
+                  m_differs = true;
+                  m_diff_open = true;
+                  m_diff_from = m_pos + i;
+                  m_excerpt.assign(data + i, min<size_t>(n - i, 32));
+               }
 
-      timespec t1,t2, tdiff = {0};
+               if( m_diff_open )
+               {
+                  for( ; i < common && p[i] != g[i]; ++i )
+                  {
+                  }
+                  if( i < common )
+                  {
+                     m_diff_open = false;
+                     m_diff_to = m_pos + i;
+                  }
+               }
+            }
 
-      for( auto & i : m_fmap )
-      {
-         if( i.first.find(m_filter) == string::npos )
-         {
-            tc_disabled(i.second);
-            continue;
+            if( m_out.is_open() )
+            {
+               m_out.write(data, n);
+            }
+            m_pos += n;
          }
 
-         auto & tc = findTC(i.second);
-
-         if( !i.second.m_disabled )
+         // the end of the output
+         void finish()
          {
-            try
-            {
-               tc.m_is_EX_happened = false;
-               clock_gettime(CLOCK_MONOTONIC, &t1);
-               i.second.m_func();
-               clock_gettime(CLOCK_MONOTONIC, &t2);
-            }
-            catch( const exception & e )
+            if( m_golden && !m_differs && m_pos < m_golden->size() )
             {
-               clock_gettime(CLOCK_MONOTONIC, &t2);
-               tc.m_is_EX_happened = true;
-               tc.m_EX_happened = typeIdName(e);
-               what = e.what();
+               m_differs = true;
+               m_diff_from = m_pos;
+               m_diff_open = true;
             }
-            catch(...)
+            if( m_diff_open )
             {
-               clock_gettime(CLOCK_MONOTONIC, &t2);
-               tc.m_is_EX_happened = true;
-               tc.m_EX_happened = "(UNKNOWN)>";
+               m_diff_to = max<unsigned long long>(m_pos, m_golden->size());
+               m_diff_open = false;
             }
+         }
 
-            tdiff = diff(t1, t2);
-            tc.m_time = tdiff.tv_sec + tdiff.tv_nsec / 1000000000.0;
+         // --update-snapshots: the new golden data (or its digest) in place of the old
+         void update( uint64_t digest )
+         {
+            const bool changed = m_golden ? m_differs : !m_has_digest || digest != m_golden_digest || m_pos != m_golden_size;
 
-            if( tc.m_is_EX_happened )
+            if( m_out.is_open() )
             {
-               Teststep ts;
-               ts.m_OK = tc.m_EX_expected == tc.m_EX_happened;
-               ts.m_desc = "<kbd><b>internally generated Teststep</b> for Testcase exception check</kbd>";
- 
-               if( tc.m_EX_expected == "" )
+               m_out.close();
+               if( rename((m_path + ".new").c_str(), m_path.c_str()) != 0 )
                {
-                  ts.m_EX_expected = "NO exception";
-               } else {
-                  ts.m_EX_expected = tc.m_EX_expected;
+                  throw runtime_error("snapshot: can't rename <" + m_path + ".new>: " + strerror(errno));
                }
+            }
 
-               if( tc.m_EX_happened == "" )
+            if( !m_out.is_open() && (m_has_digest || m_mode == Snapshot::Digest) )
+            {
+               ofstream of(m_path + ".xxh64", ios::trunc);
+               of << setw(16) << setfill('0') << hex << digest << dec << " " << m_pos << "\n";
+               if( !of )
                {
-                  ts.m_EX_happened = "UNKNOWN exception.";
-               } else {
-                  ts.m_EX_happened = tc.m_EX_happened;
+                  throw runtime_error("snapshot: can't write <" + m_path + ".xxh64>");
                }
+            }
+
+            if( changed || (!m_golden && !m_has_digest) )
+            {
+               S_Manager::getInstance().info("snapshot <" + m_path + "> written (" + to_string(m_pos) + " bytes)");
+            }
+         }
+
+         string m_path;
+         Snapshot::Mode m_mode;
+         const DataFile * m_golden = nullptr;     // the golden file, if there is one
+         bool m_has_digest = false;               // <golden>.xxh64
+         uint64_t m_golden_digest = 0;
+         unsigned long long m_golden_size = 0;
+
+         Hash64 m_hash {};
+         unsigned long long m_pos = 0;            // bytes so far
+
+         // the first differing bytes [m_diff_from, m_diff_to)
+         bool m_differs = false;
+         bool m_diff_open = false;
+         unsigned long long m_diff_from = 0;
+         unsigned long long m_diff_to = 0;
+         string m_excerpt = "";                   // actual bytes from m_diff_from
+
+         ofstream m_out {};
+         vector<char> m_buf = vector<char>(64 * 1024);
+         bool m_checked = false;
+   };
 
-               ts.m_what = what;
-               what = "";
+   Snapshot::Snapshot( const std::string & name, Mode mode ) :
+      std::ostream(nullptr),
+      m_state(new SnapshotState(name, mode))
+   {
+      rdbuf(m_state.get());
+   }
 
-               if( !ts.m_OK )
-                  tc.m_ts_FAIL++;
+   Snapshot::~Snapshot()
+   {
+      rdbuf(nullptr);
+   }
 
-               tc.m_tstep.insert(make_pair( "TC-intern", ts));
-            }
+   // bytes as C string literal, at most 32
+   string snapshotBytes( const char * p, size_t n )
+   {
+      ostringstream oss;
+      oss << '"';
+      for( size_t i = 0; i < min<size_t>(n, 32); ++i )
+      {
+         const unsigned char c = p[i];
+         if( c == '\n' )
+         {
+            oss << "\\n";
+         } else if( c == '\\' || c == '"' ) {
+            oss << '\\' << c;
+         } else if( isprint(c) && c != '<' && c != '>' && c != '&' ) {
+            oss << c;
+         } else {
+            oss << "\\x" << hex << setw(2) << setfill('0') << int(c) << dec;
          }
       }
+      oss << '"';
+      return oss.str();
    }
 
-   void Manager::genXML()
+   string hex64( uint64_t v )
    {
-      cerr << "genXML() not implemented." << endl;
+      ostringstream oss;
+      oss << hex << setw(16) << setfill('0') << v;
+      return oss.str();
    }
 
-   void Manager::genPDF()
+   void checkSnapshot( Probe & probe, Snapshot & snapshot, const std::string & str )
    {
-      if( !m_PDF )
+      SnapshotState & st = *snapshot.m_state;
+      if( st.m_checked )
       {
-         return;
+         throw runtime_error("snapshot <" + st.m_path + "> checked twice");
       }
+      st.m_checked = true;
 
-      string path;
+      snapshot.flush();
+      st.finish();
+      const uint64_t digest = st.m_hash.digest();
 
-      int fd[2];
-      if(pipe(fd) < 0)           /*create pipe */
+      if( S_Manager::getInstance().m_update_snapshots )
       {
-         throw runtime_error("no pipe");
+         st.update(digest);
+         step_passed(probe);
+         return;
       }
 
-      ::mkdir("tmp", 0774);
-
-      switch( fork() )
+      ostringstream msg;
+      if( st.m_golden )
       {
-         case -1:
-            throw runtime_error("can not fork.");
-         case 0: // child
-            close(fd[0]);
-            dup2(fd[1], fileno(stdout));
-            execlp( "which", "which", "wkhtml2pdf", (char *)0 );
-            close(fd[0]);
-            exit(0);
-      }
+         if( !st.m_differs )
+         {
+            step_passed(probe);
+            return;
+         }
 
-      close( fd[1] );
-      char line[200];
-      int n = read(fd[0], line, 199);
-      line[n] = (char)0;
-      close(fd[0]);
-      path = string(line);
+         Hash64 golden;
+         golden.update(st.m_golden->data(), st.m_golden->size());
 
-      if( path.size() == 0)
-      {
-         cout << "INFO: wkhtml2pdf not found, can't generate pdf file!\n"
-              << "  check http://code.google.com/p/wkhtmltopdf/" << endl;
+         msg << str << " differs from the snapshot at bytes [" << st.m_diff_from << ", " << st.m_diff_to
+             << ") (" << st.m_pos << " bytes, golden " << st.m_golden->size() << ")";
+         probe.m_actual = str + ": " + snapshotBytes(st.m_excerpt.data(), st.m_excerpt.size())
+            + " (xxh64 " + hex64(digest) + ")";
+
+         const size_t from = min<size_t>(st.m_diff_from, st.m_golden->size());
+         probe.m_expect = st.m_path + ": "
+            + snapshotBytes(reinterpret_cast<const char *>(st.m_golden->data()) + from, st.m_golden->size() - from)
+            + " (xxh64 " + hex64(golden.digest()) + ")";
+      } else if( st.m_has_digest ) {
+         if( digest == st.m_golden_digest && st.m_pos == st.m_golden_size )
+         {
+            step_passed(probe);
+            return;
+         }
+
+         msg << str << " differs from the snapshot digest";
+         probe.m_actual = str + ": " + to_string(st.m_pos) + " bytes, xxh64 " + hex64(digest);
+         probe.m_expect = st.m_path + ".xxh64: " + to_string(st.m_golden_size) + " bytes, xxh64 " + hex64(st.m_golden_digest);
       } else {
-         const string cmd = "wkhtml2pdf -b --zoom 0.7 -s Letter tmp/results.html tmp/results.pdf";
-         system(cmd.c_str());
-         cout << "<tmp/results.pdf> created." << endl;
+         msg << "no snapshot <" << st.m_path << "> (or .xxh64), --update-snapshots writes it";
+         probe.m_actual = str + ": " + to_string(st.m_pos) + " bytes, xxh64 " + hex64(digest);
+         probe.m_expect = st.m_path;
       }
 
+      probe.m_msg = msg.str();
+      S_Manager::getInstance().setFAIL(probe);
    }
 
-   void usage()
+   FixtureBase::FixtureBase( const std::string & name, const std::string & scope ) :
+      m_name(name),
+      m_scope(scope)
    {
-      cout << "------ CPP11UT:\n";
-      cout << "-d            : enable debug output\n";
-      cout << "-a            : details of all test steps, not just the failed ones\n";
-      cout << "-f <filter>   : disable all testcases that do NOT contain <filter>\n";
-      cout << "-nopdf        : no pdf generation\n";
-
-      cout << "-h            : show available parameters\n";
-      cout << "--help        : show available parameters\n";
-      cout << endl;
+      S_Manager::getInstance().subscribe(*this);
    }
 
-   void setParas(const ArgVS & args)
+   FixtureBase::~FixtureBase()
    {
-      Manager & mgr = S_Manager::getInstance();
-
-      auto p = args.getValue<bool>("-d");
-      if( p )
-         mgr.m_debug = true;
-
-      p = args.getValue<bool>("-a");
-      if( p )
-         mgr.m_ts_all = true;
-
-      p = args.getValue<bool>("-nopdf");
-      if( p )
-         mgr.m_PDF = false;
- 
-      p = args.getValue<bool>("-f");
-      if( p )
-      {
-         string filt = args.getValue<string>("-f");
-         mgr.setFilter(filt.c_str());
-         cout << "INFO: set filter to <" << filt << ">" << endl;
-
-      }
-
-      p = args.getValue<bool>("-h") || args.getValue<bool>("--help") ;
-      if( p )
-      {
-         usage();
-         exit(0);
-      }
+      // a module unloaded by --resident
+      S_Manager::getInstance().unsubscribe(*this);
    }
 
-   void getArgs( const int argc, char const * const argv[] )
+   const void * FixtureBase::acquire()
    {
-      ArgVS args;
-      for( int i = 0; i< argc; ++i )
+      void * obj = m_obj.load(memory_order_acquire);
+      if( obj != nullptr )
       {
-         args.m_args.push_back(argv[i]);
+         return obj;
       }
 
-      setParas(args);
-   } 
-}
-
-// === namespace UT =============================================================
-namespace UT {
-
-   void step_passed(UT::Probe & probe);
-   void step_failed_eq(UT::Probe & probe,
-                       const string & aVal,
-                       const string & bVal,
-                       const std::string & str_a,
-                       const std::string & str_b);
+      lock_guard<mutex> lock(m_mutex);
 
-   Probe::Probe(
-                const std::string & fname,          // file name where probe is located
-                const int lineNumber,               // __LINE__
-                const std::string & tpath,          // p1: tcase path; unique KEY
-                const std::string & desc,           // p2: description
-                std::function< void (void)> tfunc   // p3: lambda test function
-                ) :
-      m_fname(fname),
-      m_line(lineNumber),
-      m_tpath(tpath),
-      m_desc(desc),
-      m_func(tfunc),
+      obj = m_obj.load(memory_order_relaxed);
+      if( obj == nullptr )
+      {
+         timespec t1, t2;
+         clock_gettime(CLOCK_MONOTONIC, &t1);
+         obj = create();
+         clock_gettime(CLOCK_MONOTONIC, &t2);
+
+         const double t = seconds(t1, t2);
+         m_setup_time += t;
+         t_setup_time += t;
+         s_tracer.span("setup " + m_name, "setup", seconds(t1), seconds(t2));
+         if( t_probe != nullptr && m_first.empty() )
+         {
+            m_first = t_probe->m_tpath;
+         }
 
-      m_suite(""),
-      m_tname(""),
-      m_disabled(false)
-   {
-      convertNames(tpath, m_suite, m_tname, m_disabled);
-      S_Manager::getInstance().subscribe(*this);
+         m_obj.store(obj, memory_order_release);
+      }
+      return obj;
    }
 
-   Probe::Probe( const std::string & cmdString,   // cmd-string
-                 const std::string & data         // data
-                 )
+   void FixtureBase::release()
    {
-      if( cmdString == "setTitle" )
+      lock_guard<mutex> lock(m_mutex);
+
+      void * obj = m_obj.exchange(nullptr);
+      if( obj != nullptr )
       {
-         S_Manager::getInstance().setTitle(data);
-         return;
+         timespec t1, t2;
+         clock_gettime(CLOCK_MONOTONIC, &t1);
+         destroy(obj);
+         clock_gettime(CLOCK_MONOTONIC, &t2);
+         m_teardown_time += seconds(t1, t2);
+         s_tracer.span("teardown " + m_name, "setup", seconds(t1), seconds(t2));
       }
-
-      cerr << "ERROR: invalid cmd found: <" << cmdString << "> (ignored)." << endl;
    }
 
-   void Probe::isTrue( const bool expr, const string & exprStr )
+   Probe::~Probe() = default;
+
+   void Probe::isTrue( const bool expr, const char * exprStr )
    {
+      m_step = exprStr;
       if(expr)
       {
          step_passed(*this);
       } else {
          step_failed_isTrue( *this, exprStr );
       }
+      m_step = nullptr;
    }
 
    void Probe::isOK( const std::string & actual )
@@ -1811,6 +7776,36 @@ namespace UT {
       step_passed(*this);
    }
 
+   // forget what a previous run of the testcase left behind
+   void Probe::reset()
+   {
+      m_msg = "";
+      m_expect = "";
+      m_actual = "";
+      m_is_EX_expected = false;
+      m_is_EX_happened = false;
+      m_EX_expected = "";
+      m_EX_happened = "";
+      m_what = "";
+   }
+
+   // called in the catch(...) of a test step
+   void Probe::except()
+   {
+      try
+      {
+         throw;
+      }
+      catch( const exception & e )
+      {
+         except(e);
+      }
+      catch(...)
+      {
+         undef_except();
+      }
+   }
+
    void Probe::except( const exception & e)
    {
       ostringstream oss;
@@ -1838,6 +7833,70 @@ namespace UT {
       S_Manager::getInstance().setExpect(*this);
    }
 
+   // EXPECT_THROW_TYPE: the step is complete, an EXPECT() of the testcase stays as it is
+   void step_throw_type(UT::Probe & probe,
+                        bool okay,
+                        const std::type_info & expected,
+                        const string & actual,
+                        const string & what,
+                        const char * expr)
+   {
+      const string ex_expected = probe.m_EX_expected;
+      const string ex_happened = probe.m_EX_happened;
+
+      probe.m_EX_expected = "";
+      probe.m_EX_happened = "";
+      probe.m_expect = "[ " + string(expr) + " ] throws " + typeName(expected);
+      probe.m_actual = actual;
+      probe.m_what = what;
+      probe.m_msg = okay ? "exception happened, as expected" : "expected exception " + typeName(expected);
+      probe.m_step = expr;
+
+      if( okay )
+      {
+         S_Manager::getInstance().setOK(probe);
+      } else {
+         S_Manager::getInstance().setFAIL(probe);
+      }
+
+      probe.m_step = nullptr;
+      probe.m_EX_expected = ex_expected;
+      probe.m_EX_happened = ex_happened;
+      probe.m_what = "";
+   }
+
+   void Probe::thrown( const std::type_info & expected, const std::type_info & actual, const char * expr )
+   {
+      string str = typeName(actual);
+      if( actual != expected )
+      {
+         str += " (derived from " + typeName(expected) + ")";
+      }
+      step_throw_type(*this, true, expected, str, "", expr);
+   }
+
+   void Probe::notThrown( const std::type_info & expected, const char * expr )
+   {
+      step_throw_type(*this, false, expected, "nothing thrown", "", expr);
+   }
+
+   // called in the catch(...) of EXPECT_THROW_TYPE
+   void Probe::wrongThrown( const std::type_info & expected, const char * expr )
+   {
+      try
+      {
+         throw;
+      }
+      catch( const exception & e )
+      {
+         step_throw_type(*this, false, expected, typeName(typeid(e)), e.what(), expr);
+      }
+      catch(...)
+      {
+         step_throw_type(*this, false, expected, "(UNKNOWN) not derived from std::exception", "", expr);
+      }
+   }
+
    // undefined exception _inside_ test step
    void Probe::undef_except()
    {
@@ -1871,10 +7930,24 @@ namespace UT {
    };
 
    void step_failed_eq(UT::Probe & probe,
-                       const string & aVal,
-                       const string & bVal,
-                       const std::string & str_a,
-                       const std::string & str_b)
+                       const Value & a,
+                       const Value & b,
+                       const char * str_a,
+                       const char * str_b)
+   {
+      ostringstream ossA, ossB;
+      ossA << setprecision(20);
+      ossB << setprecision(20);
+      a.m_print(ossA, a.m_ptr);
+      b.m_print(ossB, b.m_ptr);
+      step_failed_values(probe, ossA.str(), ossB.str(), str_a, str_b);
+   }
+
+   void step_failed_values(UT::Probe & probe,
+                           const string & aVal,
+                           const string & bVal,
+                           const std::string & str_a,
+                           const std::string & str_b)
    {
       std::ostringstream oss;
       std::ostringstream oss_expect;
@@ -1908,6 +7981,108 @@ namespace UT {
       S_Manager::getInstance().setFAIL(probe);
    };
 
+   void step_failed_range(UT::Probe & probe,
+                          size_t mismatches,
+                          size_t na,
+                          size_t nb,
+                          const string & diffs,
+                          const string & how,
+                          const string & str_a,
+                          const string & str_b)
+   {
+      ostringstream oss;
+
+      if( na != nb )
+      {
+         oss << str_a << " has " << na << " elements, " << str_b << " has " << nb;
+         probe.m_actual = oss.str();
+      } else {
+         oss << mismatches << " of " << na << " elements differ" << how;
+         if( mismatches > RANGE_SHOW )
+         {
+            oss << ", the first " << RANGE_SHOW << ":";
+         }
+         probe.m_actual = str_a + ": " + diffs;
+      }
+
+      probe.m_msg = oss.str();
+      probe.m_expect = str_b;
+
+      S_Manager::getInstance().setFAIL(probe);
+   }
+
+   size_t rangeNear(const float * a, const float * b, size_t n,
+                    double absTol, double relTol,
+                    vector<size_t> & idx, size_t maxIdx)
+   {
+      return rangeBlocks(a, b, n, idx, maxIdx,
+                         [=](const float * x, const float * y, size_t len)
+                         { return countNear(x, y, len, float(absTol), float(relTol)); },
+                         [=](float x, float y)
+                         { return isNear(x, y, float(absTol), float(relTol)); });
+   }
+
+   size_t rangeNear(const double * a, const double * b, size_t n,
+                    double absTol, double relTol,
+                    vector<size_t> & idx, size_t maxIdx)
+   {
+      return rangeBlocks(a, b, n, idx, maxIdx,
+                         [=](const double * x, const double * y, size_t len)
+                         { return countNear(x, y, len, absTol, relTol); },
+                         [=](double x, double y)
+                         { return isNear(x, y, absTol, relTol); });
+   }
+
+   size_t rangeUlp(const float * a, const float * b, size_t n,
+                   unsigned long long ulps,
+                   vector<size_t> & idx, size_t maxIdx)
+   {
+      return rangeBlocks(a, b, n, idx, maxIdx,
+                         [=](const float * x, const float * y, size_t len)
+                         { return countUlp<float, uint32_t>(x, y, len, ulps); },
+                         [=](float x, float y)
+                         { return isUlp<float, uint32_t>(x, y, ulps); });
+   }
+
+   size_t rangeUlp(const double * a, const double * b, size_t n,
+                   unsigned long long ulps,
+                   vector<size_t> & idx, size_t maxIdx)
+   {
+      return rangeBlocks(a, b, n, idx, maxIdx,
+                         [=](const double * x, const double * y, size_t len)
+                         { return countUlp<double, uint64_t>(x, y, len, ulps); },
+                         [=](double x, double y)
+                         { return isUlp<double, uint64_t>(x, y, ulps); });
+   }
+
+   // bitwise equality; memcmp() is vectorized by the C library
+   size_t rangeBytes(const void * a, const void * b, size_t n, size_t size,
+                     vector<size_t> & idx, size_t maxIdx)
+   {
+      const char * pa = static_cast<const char *>(a);
+      const char * pb = static_cast<const char *>(b);
+      size_t total = 0;
+
+      for( size_t i = 0; i < n; i += RangeBlock )
+      {
+         size_t len = min(RangeBlock, n - i);
+         if( memcmp(pa + i * size, pb + i * size, len * size) == 0 )
+         {
+            continue;
+         }
+
+         for( size_t j = i; j < i + len; ++j )
+         {
+            if( memcmp(pa + j * size, pb + j * size, size) != 0 )
+            {
+               if( idx.size() < maxIdx ) idx.push_back(j);
+               ++total;
+            }
+         }
+      }
+
+      return total;
+   }
 }
 
 namespace UT
@@ -1918,6 +8093,32 @@ namespace UT
 
       Manager & mgr = S_Manager::getInstance();
 
+      s_tracer.track(0);
+      s_tracer.span("registration", "phase", mgr.m_created, monotonic());
+
+      if( mgr.m_compare.size() == 2 )
+      {
+         return compare(mgr.m_compare[0], mgr.m_compare[1]);
+      }
+
+      if( mgr.m_bench.size() == 2 )
+      {
+         return benchCompare(mgr.m_bench[0], mgr.m_bench[1], mgr.m_alpha, mgr.m_threshold);
+      }
+
+      // calibrating the step clock takes 20 ms: not in the time of the first testcase
+      StepClock::get();
+
+      if( mgr.m_modules.size() > 0 )
+      {
+         return mgr.resident();
+      }
+
+      if( mgr.m_fuzz )
+      {
+         mgr.fuzz();
+      }
+
       mgr.exec();
       mgr.genStatistics();
       mgr.printSummary();
@@ -1931,6 +8132,62 @@ namespace UT
       mgr.genXML();
       mgr.genPDF();
 
+      if( s_tracer.m_on )
+      {
+         s_tracer.write("tmp/trace.json");
+         cout << "<tmp/trace.json> generated." << endl;
+      }
+
       return 0;
    }
 }
+
+// === coverage callbacks for --fuzz ============================================
+// gcc: -fsanitize-coverage=trace-pc, clang: -fsanitize-coverage=trace-pc-guard
+// this file itself must NOT be instrumented
+#if defined(__clang__)
+#define UT_NO_COVERAGE __attribute__((no_sanitize("coverage")))
+#elif defined(__GNUC__) && __GNUC__ >= 12
+#define UT_NO_COVERAGE __attribute__((no_sanitize_coverage))
+#else
+#define UT_NO_COVERAGE
+#endif
+
+extern "C"
+{
+   UT_NO_COVERAGE void __sanitizer_cov_trace_pc_guard_init(uint32_t * start, uint32_t * stop)
+   {
+      static uint32_t n = 0;
+      if( start == stop || *start != 0 )
+      {
+         return;
+      }
+      for( uint32_t * g = start; g < stop; ++g )
+      {
+         *g = ++n;
+      }
+   }
+
+   UT_NO_COVERAGE void __sanitizer_cov_trace_pc_guard(uint32_t * guard)
+   {
+      s_cov_used = true;
+      const size_t i = *guard & (CovSize - 1);
+      if( s_cov[i]++ == 0 )
+      {
+         s_cov_touched[s_cov_ntouched++ & (CovSize - 1)] = i;
+      }
+   }
+
+   UT_NO_COVERAGE void __sanitizer_cov_trace_pc()
+   {
+      // edge = previous and current block, like AFL
+      const uintptr_t pc = reinterpret_cast<uintptr_t>(__builtin_return_address(0));
+      s_cov_used = true;
+      const size_t i = (pc ^ t_cov_prev) & (CovSize - 1);
+      if( s_cov[i]++ == 0 )
+      {
+         s_cov_touched[s_cov_ntouched++ & (CovSize - 1)] = i;
+      }
+      t_cov_prev = pc >> 1;
+   }
+}
@@ -1,12 +1,14 @@
 // -*- c++ -*- (C) 2013 by Andreas Boerner
 #pragma once
 
+// every test file includes this, so it is kept small: the steps only call
+// out of line functions, the formatting of failures is in unittest.cc.
+// range assertions, TEST_PARAM and FUZZ_TEST are in unittest_ext.h
 #include <functional> // function
-#include <iomanip>
-#include <sstream>
-#include <stdexcept>
+#include <memory>     // shared_ptr
+#include <ostream>
 #include <string>
-#include <vector>
+#include <typeinfo>   // typeid
 
 namespace {
    const char ut_s_path[] = __BASE_FILE__;
@@ -25,15 +27,24 @@ namespace {
 #define EXPECT(a) t1.expect(a)
 
 #define IS_EQUAL(a,b) try { t1.equal(a, b, UT_QUOTE(a), UT_QUOTE(b) ); }\
-   catch( const exception & e ) { t1.except(e); }\
-   catch(...) { t1.undef_except(); }
+   catch(...) { t1.except(); }
 
 #define IS_TRUE(a) try { t1.isTrue(a, UT_QUOTE(a)); }\
-   catch( const exception & e ) {t1.except(e); }\
-   catch(...) { t1.undef_except(); }
+   catch(...) { t1.except(); }
 
 #define ASSERT(a) IS_TRUE(a)
 
+// passes if expr throws T or a class derived from T; matched by the catch, not by name
+#define EXPECT_THROW_TYPE(T, expr) try { expr; t1.notThrown(typeid(T), UT_QUOTE(expr)); }\
+   catch( const T & e ) { t1.thrown(typeid(T), typeid(e), UT_QUOTE(expr)); }\
+   catch(...) { t1.wrongThrown(typeid(T), UT_QUOTE(expr)); }
+
+// testcase a (or all testcases below path a) runs after b (a testcase or a path); skipped if b failed
+#define DEPENDS(a,b) namespace UT_NS { UT::Depends t3(a, b); }
+
+// testcase a (or all testcases below path a) crashes on purpose: runs with --catch-signals, else skipped
+#define CRASHES(a) namespace UT_NS { UT::Crashes t4(a); }
+
 #define SET_TITLE(a) UT::Probe t2("setTitle", a)
 #define EXEC []()
 
@@ -42,13 +53,45 @@ namespace UT
    int utest( const int argc, const char * const argv[]);
 
    struct Probe;
+   struct FuzzTarget;
+   struct Async;
+
+   // a value of IS_EQUAL; printed (out of line) only if the step failed
+   struct Value
+   {
+         template< typename T >
+         Value(const T & v) : m_ptr(&v), m_print(&print<T>) {}
+
+         Value(const Value &) = default;
+         Value & operator=(const Value &) = default;
+
+         template< typename T >
+         static void print(std::ostream & os, const void * p)
+         {
+            os << *static_cast<const T *>(p);
+         }
+
+         const void * m_ptr;
+         void (*m_print)(std::ostream &, const void *);
+   };
+
+   struct Depends
+   {
+         Depends(const char * tpath, const char * prerequisite);
+   };
+
+   struct Crashes
+   {
+         explicit Crashes(const char * tpath);
+   };
+
    void step_passed(Probe & probe);
 
    void step_failed_eq(Probe & probe,
-                       const std::string & aVal,
-                       const std::string & bVal,
-                       const std::string & str_a,
-                       const std::string & str_b);
+                       const Value & a,
+                       const Value & b,
+                       const char * str_a,
+                       const char * str_b);
 
    struct Probe
    {
@@ -56,22 +99,58 @@ namespace UT
                const int,                    // line number
                const std::string & tpath,    // p1: tcase path; unique KEY
                const std::string &,          // p2: description
-               std::function< void (void)>   // p3: lambda test function
+               std::function< void (void)>,  // p3: lambda test function
+               const std::string & group = ""  // TEST_PARAM the probe is a row of
+               );
+
+         Probe(const std::string &,          // file name where probe is located
+               const int,                    // line number
+               const std::string & tpath,    // p1: tcase path; unique KEY
+               const std::string &,          // p2: description
+               const FuzzTarget &            // p3: FUZZ_TEST target
+               );
+
+         // TEST_CASE: no std::string and std::function built in the test file
+         Probe(const char *,                 // file name where probe is located
+               const int,                    // line number
+               const char * tpath,           // p1: tcase path; unique KEY
+               const char *,                 // p2: description
+               void (*)()                    // p3: EXEC lambda
+               );
+
+         // ASYNC_TEST
+         Probe(const char *,                 // file name where probe is located
+               const int,                    // line number
+               const char * tpath,           // p1: tcase path; unique KEY
+               const char *,                 // p2: description
+               void (*)(Async &)             // p3: AEXEC lambda
                );
 
          Probe( const std::string &,         // cmd-string
                 const std::string &          // data
                 );
 
+         Probe(const Probe &) = default;
+         Probe & operator=(const Probe &) = default;
+
+         ~Probe();
+
          void isTrue( const bool expr,
-                      const std::string & strExpr);
+                      const char * strExpr);
 
          void isOK( const std::string & actual);
+         void reset();
 
+         void except();                        // the current exception
          void except(const std::exception & e);
          void expect(const std::string & e);
          void undef_except();
 
+         // EXPECT_THROW_TYPE
+         void thrown(const std::type_info & expected, const std::type_info & actual, const char * expr);
+         void notThrown(const std::type_info & expected, const char * expr);
+         void wrongThrown(const std::type_info & expected, const char * expr);
+
          std::string dump();
 
          // data
@@ -94,22 +173,29 @@ namespace UT
          std::string m_suite = "";
          std::string m_tname = "";
          bool m_disabled = false;
+         std::string m_group = "";
+         std::shared_ptr<const FuzzTarget> m_fuzz {};
+         std::function<void (Async &)> m_async = {};
+
+         // the Manager keeps a copy of each Probe; the test steps update the original
+         Probe * m_origin = this;
+
+         const char * m_step = nullptr;   // expression of the step being recorded
 
          template< typename A, typename B >
             void equal(const A & a,
                        const B & b,
-                       const std::string & str_a,
-                       const std::string & str_b)
+                       const char * str_a,
+                       const char * str_b)
          {
+            m_step = str_a;
             if(a==b)
             {
                step_passed(*this);
             } else {
-               std::ostringstream ossA, ossB;
-               ossA << std::setprecision(20) << a;
-               ossB << std::setprecision(20) << b;
-               step_failed_eq(*this, ossA.str(), ossB.str(), str_a, str_b);
+               step_failed_eq(*this, a, b, str_a, str_b);
             }
+            m_step = nullptr;
          }
    };
 }
@@ -0,0 +1,868 @@
+// -*- c++ -*- (C) 2013 by Andreas Boerner
+#pragma once
+
+// range assertions, TEST_PARAM, FUZZ_TEST, FIXTURE, ASYNC_TEST, the VirtualClock, testData and
+// snapshots: include only where needed
+#include "unittest.h"
+
+#include <algorithm>  // min
+#include <atomic>
+#include <chrono>
+#include <cstdint>    // uint32_t
+#include <cstring>    // memcpy
+#include <exception>  // exception_ptr
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <sys/epoll.h> // EPOLLIN, EPOLLOUT
+
+// whole sequences (anything with data() and size(), or UT::range(ptr, n)) in one step
+#define IS_EQUAL_RANGE(a,b) try { UT::equalRange(t1, a, b, UT_QUOTE(a), UT_QUOTE(b) ); }\
+   catch(...) { t1.except(); }
+
+#define IS_NEAR_RANGE(a,b,abs,rel) try { UT::nearRange(t1, a, b, abs, rel, UT_QUOTE(a), UT_QUOTE(b) ); }\
+   catch(...) { t1.except(); }
+
+#define IS_ULP_RANGE(a,b,ulps) try { UT::ulpRange(t1, a, b, ulps, UT_QUOTE(a), UT_QUOTE(b) ); }\
+   catch(...) { t1.except(); }
+
+// output against a golden file: UT::Snapshot s("name"); s << ...; IS_SNAPSHOT(s);
+// or anything with data() and size() at once: IS_EQUAL_SNAPSHOT(a, "name")
+#define IS_SNAPSHOT(s) try { UT::checkSnapshot(t1, s, UT_QUOTE(s)); }\
+   catch(...) { t1.except(); }
+
+#define IS_EQUAL_SNAPSHOT(a,name) try { UT::Snapshot ut_snap(name); UT::detail::writeAll(ut_snap, a);\
+   UT::checkSnapshot(t1, ut_snap, UT_QUOTE(a)); }\
+   catch(...) { t1.except(); }
+
+// one testcase per row: TEST_PARAM("suite/name", "desc", rows, PEXEC(const Row & r) { ... })
+// rows is any container, e.g. a table, UT::generate() or UT::cartesian()
+#define TEST_PARAM(a,b,rows,c) namespace UT_NS { UT::ParamProbe t1(ut_s_path, __LINE__,a,b,rows,c); }
+#define PEXEC(...) [](UT::Probe & t1, __VA_ARGS__)
+
+// fuzz target: FUZZ_TEST("suite/name", "desc", FEXEC(float a, float b) { ... })
+// a normal run replays the saved inputs (--corpus), --fuzz generates new ones
+#define FUZZ_TEST(a,b,c) namespace UT_NS { UT::Probe t1(ut_s_path, __LINE__,a,b,UT::fuzzTarget(c)); }
+#define FEXEC(...) [](__VA_ARGS__)
+
+// shared object: FIXTURE(name, "suite" or "", Type, { return new Type(...); }), name.get() in the tests
+// built on first get(), destroyed after the last selected testcase below the scope ran
+#define FIXTURE(name, scope, T, ...) UT::Fixture<T> name(#name, scope, []() -> T * __VA_ARGS__)
+
+// I/O bound testcase on the event loop: ASYNC_TEST("suite/name", "desc", AEXEC { ... as.done(); })
+// the body starts the I/O and returns, the callbacks it registers on as finish the job
+#define ASYNC_TEST(a,b,...) namespace UT_NS { UT::Probe t1(ut_s_path, __LINE__,a,b,+__VA_ARGS__); }
+#define AEXEC [](UT::Async & as)
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#include <coroutine>
+#define UT_COROUTINES 1
+
+// the same as a C++20 coroutine: CO_TEST("suite/name", "desc", { co_await as.readable(fd); ... })
+// done when the body returns
+#define CO_TEST(a,b,...) namespace UT_NS { UT::Task t0(UT::Async & as);\
+   UT::Probe t1(ut_s_path, __LINE__,a,b,+[](UT::Async & as) { t0(as); });\
+   UT::Task t0(UT::Async & as) __VA_ARGS__ }
+#endif
+
+namespace UT
+{
+   // number of differing elements listed by the range assertions
+   const std::size_t RANGE_SHOW = 10;
+
+   // bulk comparison kernels (SIMD where available); return the number of
+   // mismatches and collect the first maxIdx mismatching indices in idx
+   std::size_t rangeNear(const float * a, const float * b, std::size_t n,
+                         double absTol, double relTol,
+                         std::vector<std::size_t> & idx, std::size_t maxIdx);
+   std::size_t rangeNear(const double * a, const double * b, std::size_t n,
+                         double absTol, double relTol,
+                         std::vector<std::size_t> & idx, std::size_t maxIdx);
+   std::size_t rangeUlp(const float * a, const float * b, std::size_t n,
+                        unsigned long long ulps,
+                        std::vector<std::size_t> & idx, std::size_t maxIdx);
+   std::size_t rangeUlp(const double * a, const double * b, std::size_t n,
+                        unsigned long long ulps,
+                        std::vector<std::size_t> & idx, std::size_t maxIdx);
+   std::size_t rangeBytes(const void * a, const void * b, std::size_t n, std::size_t size,
+                          std::vector<std::size_t> & idx, std::size_t maxIdx);
+
+   void step_failed_range(Probe & probe,
+                          std::size_t mismatches,
+                          std::size_t na,
+                          std::size_t nb,
+                          const std::string & diffs,
+                          const std::string & how,
+                          const std::string & str_a,
+                          const std::string & str_b);
+
+   // view of n elements at ptr, for the range assertions
+   template< typename T >
+   struct Range
+   {
+         const T * data() const { return m_data; }
+         std::size_t size() const { return m_size; }
+
+         const T * m_data;
+         std::size_t m_size;
+   };
+
+   template< typename T >
+   Range<T> range(const T * ptr, std::size_t n)
+   {
+      return Range<T>{ptr, n};
+   }
+
+   namespace detail
+   {
+      template< typename C >
+      struct ElementOf
+      {
+            typedef typename std::remove_cv<
+               typename std::remove_reference<decltype(*std::declval<const C &>().data())>::type >::type type;
+      };
+
+      inline std::size_t rangeEqual(const float * a, const float * b, std::size_t n,
+                                    std::vector<std::size_t> & idx, std::size_t k)
+      {
+         return rangeNear(a, b, n, 0.0, 0.0, idx, k);
+      }
+
+      inline std::size_t rangeEqual(const double * a, const double * b, std::size_t n,
+                                    std::vector<std::size_t> & idx, std::size_t k)
+      {
+         return rangeNear(a, b, n, 0.0, 0.0, idx, k);
+      }
+
+      template< typename T >
+      std::size_t rangeEqual(const T * a, const T * b, std::size_t n,
+                             std::vector<std::size_t> & idx, std::size_t k)
+      {
+         // same bits <=> same value
+         if( std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value )
+         {
+            return rangeBytes(a, b, n, sizeof(T), idx, k);
+         }
+
+         std::size_t c = 0;
+         for( std::size_t i = 0; i < n; ++i )
+         {
+            if( !(a[i] == b[i]) )
+            {
+               if( idx.size() < k ) idx.push_back(i);
+               ++c;
+            }
+         }
+         return c;
+      }
+
+      inline std::size_t rangeNear(const float * a, const float * b, std::size_t n,
+                                   double absTol, double relTol,
+                                   std::vector<std::size_t> & idx, std::size_t k)
+      {
+         return UT::rangeNear(a, b, n, absTol, relTol, idx, k);
+      }
+
+      inline std::size_t rangeNear(const double * a, const double * b, std::size_t n,
+                                   double absTol, double relTol,
+                                   std::vector<std::size_t> & idx, std::size_t k)
+      {
+         return UT::rangeNear(a, b, n, absTol, relTol, idx, k);
+      }
+
+      template< typename T >
+      std::size_t rangeNear(const T * a, const T * b, std::size_t n,
+                            double absTol, double relTol,
+                            std::vector<std::size_t> & idx, std::size_t k)
+      {
+         std::size_t c = 0;
+         for( std::size_t i = 0; i < n; ++i )
+         {
+            const double x = a[i];
+            const double y = b[i];
+            const double d = x > y ? x - y : y - x;
+            const double m = (x < 0 ? -x : x) > (y < 0 ? -y : y) ? (x < 0 ? -x : x) : (y < 0 ? -y : y);
+            if( !(x == y || d <= absTol || d <= relTol * m) )
+            {
+               if( idx.size() < k ) idx.push_back(i);
+               ++c;
+            }
+         }
+         return c;
+      }
+
+      template< typename T >
+      std::size_t rangeUlp(const T * a, const T * b, std::size_t n,
+                           unsigned long long ulps,
+                           std::vector<std::size_t> & idx, std::size_t k)
+      {
+         static_assert(std::is_floating_point<T>::value, "IS_ULP_RANGE needs float or double elements");
+         return UT::rangeUlp(a, b, n, ulps, idx, k);
+      }
+   }
+
+   // how the fuzzer mutates an argument of a FUZZ_TEST
+   enum FuzzKind { FUZZ_SIGNED, FUZZ_UNSIGNED, FUZZ_FLOAT, FUZZ_BOOL, FUZZ_STRING };
+
+   struct FuzzSlot
+   {
+         FuzzKind m_kind;
+         std::size_t m_size;  // bytes; 0 for strings (length byte + data)
+   };
+
+   struct FuzzTarget
+   {
+         std::vector<FuzzSlot> m_layout {};
+         // decodes the arguments from the input bytes and calls the lambda
+         std::function< void (const unsigned char *, std::size_t) > m_func {};
+         // the decoded arguments, for the report
+         std::function< std::string (const unsigned char *, std::size_t) > m_show {};
+   };
+
+   // the range assertions
+   template< typename A, typename B, typename F >
+   void rangeCheck(Probe & probe,
+                   const A & a,
+                   const B & b,
+                   const std::string & how,
+                   const std::string & str_a,
+                   const std::string & str_b,
+                   F compare)
+   {
+      typedef typename detail::ElementOf<A>::type T;
+      static_assert(std::is_same<T, typename detail::ElementOf<B>::type>::value,
+                    "range assertions need the same element type on both sides");
+
+      std::vector<std::size_t> idx;
+      std::size_t mismatches = 0;
+
+      if( a.size() == b.size() )
+      {
+         mismatches = compare(a.data(), b.data(), a.size(), idx);
+         if( mismatches == 0 )
+         {
+            step_passed(probe);
+            return;
+         }
+      }
+
+      std::ostringstream oss;
+      oss << std::setprecision(std::numeric_limits<T>::max_digits10);
+      for( auto i : idx )
+      {
+         oss << "[" << i << "] " << a.data()[i] << " != " << b.data()[i] << "; ";
+      }
+
+      step_failed_range(probe, mismatches, a.size(), b.size(), oss.str(), how, str_a, str_b);
+   }
+
+   template< typename A, typename B >
+   void equalRange(Probe & probe,
+                   const A & a,
+                   const B & b,
+                   const std::string & str_a,
+                   const std::string & str_b)
+   {
+      rangeCheck(probe, a, b, "", str_a, str_b,
+                 [](const typename detail::ElementOf<A>::type * pa,
+                    const typename detail::ElementOf<A>::type * pb,
+                    std::size_t n, std::vector<std::size_t> & idx)
+                 { return detail::rangeEqual(pa, pb, n, idx, RANGE_SHOW); });
+   }
+
+   template< typename A, typename B >
+   void nearRange(Probe & probe,
+                  const A & a,
+                  const B & b,
+                  const double absTol,
+                  const double relTol,
+                  const std::string & str_a,
+                  const std::string & str_b)
+   {
+      std::ostringstream how;
+      how << " (abs. tolerance " << absTol << ", rel. tolerance " << relTol << ")";
+      rangeCheck(probe, a, b, how.str(), str_a, str_b,
+                 [absTol, relTol](const typename detail::ElementOf<A>::type * pa,
+                                  const typename detail::ElementOf<A>::type * pb,
+                                  std::size_t n, std::vector<std::size_t> & idx)
+                 { return detail::rangeNear(pa, pb, n, absTol, relTol, idx, RANGE_SHOW); });
+   }
+
+   template< typename A, typename B >
+   void ulpRange(Probe & probe,
+                 const A & a,
+                 const B & b,
+                 const unsigned long long ulps,
+                 const std::string & str_a,
+                 const std::string & str_b)
+   {
+      std::ostringstream how;
+      how << " (within " << ulps << " ULPs)";
+      rangeCheck(probe, a, b, how.str(), str_a, str_b,
+                 [ulps](const typename detail::ElementOf<A>::type * pa,
+                        const typename detail::ElementOf<A>::type * pb,
+                        std::size_t n, std::vector<std::size_t> & idx)
+                 { return detail::rangeUlp(pa, pb, n, ulps, idx, RANGE_SHOW); });
+   }
+
+   namespace detail
+   {
+      template< typename T >
+      struct IsPrintable
+      {
+            template< typename U >
+            static auto test(int) -> decltype(std::declval<std::ostream &>() << std::declval<const U &>(), std::true_type());
+            template< typename U >
+            static std::false_type test(...);
+
+            static const bool value = decltype(test<T>(0))::value;
+      };
+
+      template< std::size_t I, typename... T >
+      typename std::enable_if< I == sizeof...(T) >::type
+      printTuple(std::ostream &, const std::tuple<T...> &)
+      {
+      }
+
+      template< std::size_t I, typename... T >
+      typename std::enable_if< I < sizeof...(T) >::type
+      printTuple(std::ostream & os, const std::tuple<T...> & t)
+      {
+         os << (I == 0 ? "" : ", ") << std::get<I>(t);
+         printTuple<I + 1>(os, t);
+      }
+
+      template< typename... T >
+      void printRow(std::ostream & os, const std::tuple<T...> & row)
+      {
+         os << " (";
+         printTuple<0>(os, row);
+         os << ")";
+      }
+
+      template< typename T >
+      typename std::enable_if< IsPrintable<T>::value >::type
+      printRow(std::ostream & os, const T & row)
+      {
+         os << " (" << row << ")";
+      }
+
+      template< typename T >
+      typename std::enable_if< !IsPrintable<T>::value >::type
+      printRow(std::ostream &, const T &)
+      {
+      }
+   }
+
+   // the rows of a TEST_PARAM register as testcases "<name>/#<row>"
+   struct ParamProbe
+   {
+         template< typename Rows, typename F >
+         ParamProbe(const std::string & fname,
+                    const int line,
+                    const std::string & tpath,
+                    const std::string & desc,
+                    const Rows & rows,
+                    F func) : m_rows()
+         {
+            const std::string Disable = "/DISABLE";
+            std::string base = tpath;
+            std::string suffix = "";
+            if( base.size() > Disable.size() &&
+                base.compare(base.size() - Disable.size(), Disable.size(), Disable) == 0 )
+            {
+               base.erase(base.size() - Disable.size());
+               suffix = Disable;
+            }
+
+            const std::size_t n = std::distance(std::begin(rows), std::end(rows));
+            const int width = std::to_string(n).size();
+
+            std::size_t i = 0;
+            for( const auto & row : rows )
+            {
+               std::ostringstream path, rdesc;
+               path << base << "/#" << std::setfill('0') << std::setw(width) << i++ << suffix;
+               rdesc << desc;
+               detail::printRow(rdesc, row);
+
+               // the row's probe is created afterwards, so the lambda reaches it through ctx
+               auto ctx = std::make_shared<Probe *>(nullptr);
+               auto r = row;
+               std::function< void (void) > fn = [ctx, r, func]() { func(**ctx, r); };
+
+               m_rows.push_back( std::unique_ptr<Probe>(new Probe(fname, line, path.str(), rdesc.str(), fn, base)) );
+               *ctx = m_rows.back().get();
+            }
+         }
+
+         std::vector< std::unique_ptr<Probe> > m_rows;
+   };
+
+   // rows f(0) ... f(n-1)
+   template< typename F >
+   auto generate(const std::size_t n, F f) -> std::vector< decltype(f(std::size_t(0))) >
+   {
+      std::vector< decltype(f(std::size_t(0))) > rows;
+      rows.reserve(n);
+      for( std::size_t i = 0; i < n; ++i )
+      {
+         rows.push_back(f(i));
+      }
+      return rows;
+   }
+
+   // all combinations of the values, as tuples
+   template< typename T >
+   std::vector< std::tuple<T> > cartesian(const std::vector<T> & v)
+   {
+      std::vector< std::tuple<T> > rows;
+      for( const auto & a : v )
+      {
+         rows.push_back(std::make_tuple(a));
+      }
+      return rows;
+   }
+
+   template< typename T, typename... R >
+   std::vector< std::tuple<T, R...> > cartesian(const std::vector<T> & v, const std::vector<R> & ... rest)
+   {
+      std::vector< std::tuple<T, R...> > rows;
+      auto tails = cartesian(rest...);
+      for( const auto & a : v )
+      {
+         for( const auto & t : tails )
+         {
+            rows.push_back(std::tuple_cat(std::make_tuple(a), t));
+         }
+      }
+      return rows;
+   }
+
+   namespace detail
+   {
+      struct FuzzInput
+      {
+            const unsigned char * m_data;
+            std::size_t m_size;
+            std::size_t m_pos;
+      };
+
+      // missing bytes at the end of the input are zero
+      template< typename T >
+      typename std::enable_if< std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, T >::type
+      fuzzValue(FuzzInput & in)
+      {
+         unsigned char buf[sizeof(T)] = {};
+         for( std::size_t i = 0; i < sizeof(T) && in.m_pos < in.m_size; ++i )
+         {
+            buf[i] = in.m_data[in.m_pos++];
+         }
+         T v;
+         std::memcpy(&v, buf, sizeof(T));
+         return v;
+      }
+
+      template< typename T >
+      typename std::enable_if< std::is_same<T, bool>::value, T >::type
+      fuzzValue(FuzzInput & in)
+      {
+         return in.m_pos < in.m_size ? (in.m_data[in.m_pos++] & 1) : false;
+      }
+
+      template< typename T >
+      typename std::enable_if< std::is_same<T, std::string>::value, T >::type
+      fuzzValue(FuzzInput & in)
+      {
+         std::size_t len = in.m_pos < in.m_size ? in.m_data[in.m_pos++] : 0;
+         len = std::min(len, in.m_size - in.m_pos);
+         std::string v(reinterpret_cast<const char *>(in.m_data + in.m_pos), len);
+         in.m_pos += len;
+         return v;
+      }
+
+      template< typename T >
+      FuzzSlot fuzzSlot()
+      {
+         static_assert(std::is_arithmetic<T>::value || std::is_same<T, std::string>::value,
+                       "FUZZ_TEST arguments must be arithmetic types or std::string");
+         if( std::is_same<T, std::string>::value ) return FuzzSlot{FUZZ_STRING, 0};
+         if( std::is_same<T, bool>::value ) return FuzzSlot{FUZZ_BOOL, 1};
+         if( std::is_floating_point<T>::value ) return FuzzSlot{FUZZ_FLOAT, sizeof(T)};
+         if( std::is_signed<T>::value ) return FuzzSlot{FUZZ_SIGNED, sizeof(T)};
+         return FuzzSlot{FUZZ_UNSIGNED, sizeof(T)};
+      }
+
+      template< int... > struct Seq {};
+      template< int N, int... S > struct GenSeq : GenSeq<N - 1, N - 1, S...> {};
+      template< int... S > struct GenSeq<0, S...> { typedef Seq<S...> type; };
+
+      template< typename F, typename... A, int... S >
+      void callTuple(const F & f, const std::tuple<A...> & args, Seq<S...>)
+      {
+         f(std::get<S>(args)...);
+      }
+
+      template< typename T >
+      struct FuzzArgs : FuzzArgs< decltype(&T::operator()) > {};
+
+      template< typename C, typename R, typename... A >
+      struct FuzzArgs< R (C::*)(A...) const >
+      {
+            typedef std::tuple< typename std::decay<A>::type... > Args;
+
+            template< typename F >
+            static FuzzTarget make(F f)
+            {
+               FuzzTarget t;
+               t.m_layout = { fuzzSlot< typename std::decay<A>::type >()... };
+
+               t.m_func = [f](const unsigned char * data, std::size_t size)
+               {
+                  FuzzInput in{data, size, 0};
+                  // braced init: the arguments are decoded left to right
+                  Args args{ fuzzValue< typename std::decay<A>::type >(in)... };
+                  callTuple(f, args, typename GenSeq<sizeof...(A)>::type());
+               };
+
+               t.m_show = [](const unsigned char * data, std::size_t size)
+               {
+                  FuzzInput in{data, size, 0};
+                  Args args{ fuzzValue< typename std::decay<A>::type >(in)... };
+                  std::ostringstream oss;
+                  oss << std::setprecision(20);
+                  printRow(oss, args);
+                  return oss.str();
+               };
+
+               return t;
+            }
+      };
+   }
+
+   template< typename F >
+   FuzzTarget fuzzTarget(F f)
+   {
+      return detail::FuzzArgs<F>::make(f);
+   }
+
+   // the part of a FIXTURE the Manager sees
+   struct FixtureBase
+   {
+         FixtureBase(const std::string & name, const std::string & scope);
+         FixtureBase(const FixtureBase &) = delete;
+         FixtureBase & operator=(const FixtureBase &) = delete;
+         virtual ~FixtureBase();
+
+         // the object; built once, whichever thread comes first
+         const void * acquire();
+         void release();
+
+         std::string m_name;
+         std::string m_scope;
+
+         std::atomic<void *> m_obj {nullptr};
+         std::mutex m_mutex {};
+         std::atomic<int> m_left {0};      // selected testcases in scope still to run
+         int m_users = 0;
+         std::string m_first = "";         // the testcase that paid for the setup
+         double m_setup_time = 0.0;
+         double m_teardown_time = 0.0;
+
+      protected:
+         virtual void * create() = 0;
+         virtual void destroy(void * obj) = 0;
+   };
+
+   template< typename T >
+   struct Fixture : FixtureBase
+   {
+         Fixture(const std::string & name, const std::string & scope, std::function< T * (void) > make) :
+            FixtureBase(name, scope), m_make(make)
+         {
+         }
+
+         ~Fixture()
+         {
+            release();
+         }
+
+         // shared with the other testcases (and threads): read only
+         const T & get()
+         {
+            return *static_cast<const T *>(acquire());
+         }
+
+      protected:
+         void * create() override
+         {
+            return m_make();
+         }
+
+         void destroy(void * obj) override
+         {
+            delete static_cast<T *>(obj);
+         }
+
+         std::function< T * (void) > m_make;
+   };
+
+   // a test data file mapped read only (mmap); one mapping per file for all testcases and
+   // threads until the end of the run, a fork() shares it. The testcase gets the bytes, no copy
+   struct DataFile
+   {
+         enum Flags
+         {
+            Populate = 1,   // MAP_POPULATE: read it all in at the first testData()
+            HugePages = 2   // madvise(MADV_HUGEPAGE), where the file system supports it
+         };
+
+         const unsigned char * data() const { return m_data; }
+         std::size_t size() const { return m_size; }
+         const unsigned char * begin() const { return m_data; }
+         const unsigned char * end() const { return m_data + m_size; }
+
+         // the file as an array of T, e.g. for IS_EQUAL_RANGE
+         template< typename T >
+         Range<T> view() const
+         {
+            return Range<T>{ reinterpret_cast<const T *>(m_data), m_size / sizeof(T) };
+         }
+
+         std::string m_path;
+         const unsigned char * m_data;
+         std::size_t m_size;
+   };
+
+   // name is relative to the data root (--data <dir>, else $UT_DATA, else "data");
+   // the flags of the first call for a file count. Throws if it can't be mapped
+   const DataFile & testData(const std::string & name, int flags = 0);
+
+   struct SnapshotState;
+
+   // output compared with a golden file while it is written, nothing of it is kept:
+   // UT::Snapshot s("report.txt"); s << ...; (or s.write(p, n)) IS_SNAPSHOT(s);
+   // The golden file is <data root>/name (mapped, chunk by chunk); if there is only
+   // name.xxh64, the XXH64 digest and the size are compared. With --update-snapshots
+   // the golden file (Digest: name.xxh64 only) is written instead
+   struct Snapshot : std::ostream
+   {
+         enum Mode { Bytes, Digest };
+
+         explicit Snapshot(const std::string & name, Mode mode = Bytes);
+         Snapshot(const Snapshot &) = delete;
+         Snapshot & operator=(const Snapshot &) = delete;
+         ~Snapshot();
+
+         std::unique_ptr<SnapshotState> m_state;
+   };
+
+   void checkSnapshot(Probe & probe, Snapshot & snapshot, const std::string & str);
+
+   namespace detail
+   {
+      template< typename C >
+      void writeAll(std::ostream & os, const C & c)
+      {
+         os.write(reinterpret_cast<const char *>(c.data()), c.size() * sizeof(*c.data()));
+      }
+   }
+
+   // the simulated time of one testcase and its timers
+   struct ClockState
+   {
+         std::chrono::nanoseconds m_now {0};
+         std::multimap< std::chrono::nanoseconds, std::function<void (void)> > m_timers {};  // same time: in order
+   };
+
+   // simulated time for retry, backoff and timeout logic. The code under test takes its clock
+   // as a template parameter (Clock::now(), Clock::sleep_for()), the test passes UT::VirtualClock.
+   // Each testcase starts at 0; sleeping and advancing cost no real time.
+   struct VirtualClock
+   {
+         typedef std::chrono::nanoseconds duration;
+         typedef duration::rep rep;
+         typedef duration::period period;
+         typedef std::chrono::time_point<VirtualClock> time_point;
+         static const bool is_steady = true;
+
+         static time_point now();
+
+         // moves the time forward; the timers due on the way run at their time
+         static void advance_to(const time_point & t);
+
+         template< typename Rep, typename Period >
+         static void advance(const std::chrono::duration<Rep, Period> & d)
+         {
+            advance_to(now() + std::chrono::duration_cast<duration>(d));
+         }
+
+         template< typename Rep, typename Period >
+         static void sleep_for(const std::chrono::duration<Rep, Period> & d)
+         {
+            advance(d);
+         }
+
+         static void sleep_until(const time_point & t)
+         {
+            advance_to(t);
+         }
+
+         // f runs when the time gets to t (by an advance, a sleep)
+         static void at(const time_point & t, std::function<void (void)> f);
+
+         template< typename Rep, typename Period >
+         static void after(const std::chrono::duration<Rep, Period> & d, std::function<void (void)> f)
+         {
+            at(now() + std::chrono::duration_cast<duration>(d), f);
+         }
+
+         static std::size_t pending();   // timers that did not run yet
+   };
+
+   struct AsyncLoop;
+
+   // an ASYNC_TEST on the event loop (epoll) of the Manager: all of them run
+   // in one thread, each one from its body until done(), a failure or its timeout
+   struct Async
+   {
+         Async(AsyncLoop & loop, Probe & probe);
+         Async(const Async &) = delete;
+         Async & operator=(const Async &) = delete;
+
+         // f(events) whenever fd is ready for events (EPOLLIN, EPOLLOUT, ...), until off(fd)
+         void on(int fd, std::uint32_t events, std::function< void (std::uint32_t) > f);
+         void off(int fd);
+
+         // f once, seconds from now
+         void after(double seconds, std::function< void (void) > f);
+
+         // fails the testcase unless done() by then; the default is --async-timeout
+         void timeout(double seconds);
+
+         void done();
+         void fail(std::exception_ptr e);   // an exception outside of the loop's callbacks
+
+         bool isDone() const
+         {
+            return m_done;
+         }
+
+#ifdef UT_COROUTINES
+         // co_await as.readable(fd), as.writable(fd), as.sleep(s)
+         struct Awaiter
+         {
+               Async & m_as;
+               int m_fd;
+               std::uint32_t m_events;
+               double m_seconds;
+
+               bool await_ready() const noexcept
+               {
+                  return m_as.m_done;
+               }
+
+               bool await_suspend(std::coroutine_handle<> h)
+               {
+                  Async * as = &m_as;
+                  const int fd = m_fd;
+                  auto resume = [as, h]()
+                  {
+                     as->m_cancel = nullptr;
+                     h.resume();
+                  };
+
+                  as->m_cancel = [h]() { h.destroy(); };
+                  if( fd < 0 )
+                  {
+                     as->after(m_seconds, resume);
+                  } else {
+                     as->on(fd, m_events, [as, fd, resume](std::uint32_t) { as->off(fd); resume(); });
+                  }
+                  return true;
+               }
+
+               void await_resume() const noexcept
+               {
+               }
+         };
+
+         Awaiter readable(int fd)
+         {
+            return Awaiter{*this, fd, EPOLLIN, 0.0};
+         }
+
+         Awaiter writable(int fd)
+         {
+            return Awaiter{*this, fd, EPOLLOUT, 0.0};
+         }
+
+         Awaiter sleep(double seconds)
+         {
+            return Awaiter{*this, -1, 0, seconds};
+         }
+#endif
+
+         AsyncLoop & m_loop;
+         Probe & m_probe;
+
+         bool m_done = false;
+         bool m_timedout = false;
+         double m_start = 0.0;           // first resume
+         double m_end = 0.0;             // done()
+         double m_deadline = 0.0;
+         double m_setup_time = 0.0;      // fixtures built by its callbacks
+         std::vector<int> m_fds {};
+         std::function< void (void) > m_cancel {};   // destroys a suspended coroutine
+         std::exception_ptr m_error {};
+         int m_sig = 0;                  // --catch-signals
+         ClockState m_clock {};          // its VirtualClock
+         std::string m_backtrace = "";
+   };
+
+#ifdef UT_COROUTINES
+   // the return type of a CO_TEST; runs eagerly, ends the testcase when it returns
+   struct Task
+   {
+         struct promise_type
+         {
+               Async & m_as;
+
+               promise_type(Async & as) : m_as(as)
+               {
+               }
+
+               Task get_return_object()
+               {
+                  return Task();
+               }
+
+               std::suspend_never initial_suspend() noexcept
+               {
+                  return {};
+               }
+
+               std::suspend_never final_suspend() noexcept
+               {
+                  return {};
+               }
+
+               void return_void()
+               {
+                  m_as.done();
+               }
+
+               void unhandled_exception()
+               {
+                  m_as.fail(std::current_exception());
+               }
+         };
+   };
+#endif
+}